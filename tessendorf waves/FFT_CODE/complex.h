@@ -8,229 +8,241 @@
 #ifndef _COMPLEX_H_
 #define _COMPLEX_H_
 
-class complex
+//   T - type of real and imaginary parts, float or double
+template <typename T>
+class tcomplex
 {
 protected:
 	//   Internal presentation - real and imaginary parts
-	double m_re;
-	double m_im;
+	T m_re;
+	T m_im;
 
 public:
 	//   Imaginary unity
-	static const complex i;
-	static const complex j;
+	static const tcomplex i;
+	static const tcomplex j;
 
 	//   Constructors
-	complex(): m_re(0.), m_im(0.) {}
-	complex(double re, double im): m_re(re), m_im(im) {}
-	complex(double val): m_re(val), m_im(0.) {}
+	tcomplex(): m_re(0), m_im(0) {}
+	tcomplex(T re, T im): m_re(re), m_im(im) {}
+	tcomplex(T val): m_re(val), m_im(0) {}
 
 	//   Assignment
-	complex& operator= (const double val)
+	tcomplex& operator= (const T val)
 	{
 		m_re = val;
-		m_im = 0.;
+		m_im = 0;
 		return *this;
 	}
 
 	//   Basic operations - taking parts
-	double re() const { return m_re; }
-	double im() const { return m_im; }
+	T re() const { return m_re; }
+	T im() const { return m_im; }
 
-	void re(double val) { m_re = val; }
-	void im(double val) { m_im = val; }
+	void re(T val) { m_re = val; }
+	void im(T val) { m_im = val; }
 
 	//   Conjugate number
-	complex conjugate() const
+	tcomplex conjugate() const
 	{
-		return complex(m_re, -m_im);
+		return tcomplex(m_re, -m_im);
 	}
 
 	//   Norm   
-	double norm() const
+	T norm() const
 	{
 		return m_re * m_re + m_im * m_im;
 	}
 
 	//   Arithmetic operations
-	complex operator+ (const complex& other) const
+	tcomplex operator+ (const tcomplex& other) const
 	{
-		return complex(m_re + other.m_re, m_im + other.m_im);
+		return tcomplex(m_re + other.m_re, m_im + other.m_im);
 	}
 
-	complex operator- (const complex& other) const
+	tcomplex operator- (const tcomplex& other) const
 	{
-		return complex(m_re - other.m_re, m_im - other.m_im);
+		return tcomplex(m_re - other.m_re, m_im - other.m_im);
 	}
 
-	complex operator* (const complex& other) const
+	tcomplex operator* (const tcomplex& other) const
 	{
-		return complex(m_re * other.m_re - m_im * other.m_im,
+		return tcomplex(m_re * other.m_re - m_im * other.m_im,
 			m_re * other.m_im + m_im * other.m_re);
 	}
 
-	complex operator/ (const complex& other) const
+	tcomplex operator/ (const tcomplex& other) const
 	{
-		const double denominator = other.m_re * other.m_re + other.m_im * other.m_im;
-		return complex((m_re * other.m_re + m_im * other.m_im) / denominator,
+		const T denominator = other.m_re * other.m_re + other.m_im * other.m_im;
+		return tcomplex((m_re * other.m_re + m_im * other.m_im) / denominator,
 			(m_im * other.m_re - m_re * other.m_im) / denominator);
 	}
 
-	complex& operator+= (const complex& other)
+	tcomplex& operator+= (const tcomplex& other)
 	{
 		m_re += other.m_re;
 		m_im += other.m_im;
 		return *this;
 	}
 
-	complex& operator-= (const complex& other)
+	tcomplex& operator-= (const tcomplex& other)
 	{
 		m_re -= other.m_re;
 		m_im -= other.m_im;
 		return *this;
 	}
 
-	complex& operator*= (const complex& other)
+	tcomplex& operator*= (const tcomplex& other)
 	{
-		const double temp = m_re;
+		const T temp = m_re;
 		m_re = m_re * other.m_re - m_im * other.m_im;
 		m_im = m_im * other.m_re + temp * other.m_im;
 		return *this;
 	}
 
-	complex& operator/= (const complex& other)
+	tcomplex& operator/= (const tcomplex& other)
 	{
-		const double denominator = other.m_re * other.m_re + other.m_im * other.m_im;
-		const double temp = m_re;
+		const T denominator = other.m_re * other.m_re + other.m_im * other.m_im;
+		const T temp = m_re;
 		m_re = (m_re * other.m_re + m_im * other.m_im) / denominator;
 		m_im = (m_im * other.m_re - temp * other.m_im) / denominator;
 		return *this;
 	}
 
-	complex& operator++ ()
+	tcomplex& operator++ ()
 	{
 		++m_re;
 		return *this;
 	}
 
-	complex operator++ (int)
+	tcomplex operator++ (int)
 	{
-		complex temp(*this);
+		tcomplex temp(*this);
 		++m_re;
 		return temp;
 	}
 
-	complex& operator-- ()
+	tcomplex& operator-- ()
 	{
 		--m_re;
 		return *this;
 	}
 
-	complex operator-- (int)
+	tcomplex operator-- (int)
 	{
-		complex temp(*this);
+		tcomplex temp(*this);
 		--m_re;
 		return temp;
 	}
 
-	complex operator+ (const double val) const
+	tcomplex operator+ (const T val) const
 	{
-		return complex(m_re + val, m_im);
+		return tcomplex(m_re + val, m_im);
 	}
 
-	complex operator- (const double val) const
+	tcomplex operator- (const T val) const
 	{
-		return complex(m_re - val, m_im);
+		return tcomplex(m_re - val, m_im);
 	}
 
-	complex operator* (const double val) const
+	tcomplex operator* (const T val) const
 	{
-		return complex(m_re * val, m_im * val);
+		return tcomplex(m_re * val, m_im * val);
 	}
 
-	complex operator/ (const double val) const
+	tcomplex operator/ (const T val) const
 	{
-		return complex(m_re / val, m_im / val);
+		return tcomplex(m_re / val, m_im / val);
 	}
 
-	complex& operator+= (const double val)
+	tcomplex& operator+= (const T val)
 	{
 		m_re += val;
 		return *this;
 	}
 
-	complex& operator-= (const double val)
+	tcomplex& operator-= (const T val)
 	{
 		m_re -= val;
 		return *this;
 	}
 
-	complex& operator*= (const double val)
+	tcomplex& operator*= (const T val)
 	{
 		m_re *= val;
 		m_im *= val;
 		return *this;
 	}
 
-	complex& operator/= (const double val)
+	tcomplex& operator/= (const T val)
 	{
 		m_re /= val;
 		m_im /= val;
 		return *this;
 	}
 
-	friend complex operator+ (const double left, const complex& right)
+	friend tcomplex operator+ (const T left, const tcomplex& right)
 	{
-		return complex(left + right.m_re, right.m_im);
+		return tcomplex(left + right.m_re, right.m_im);
 	}
 
-	friend complex operator- (const double left, const complex& right)
+	friend tcomplex operator- (const T left, const tcomplex& right)
 	{
-		return complex(left - right.m_re, -right.m_im);
+		return tcomplex(left - right.m_re, -right.m_im);
 	}
 
-	friend complex operator* (const double left, const complex& right)
+	friend tcomplex operator* (const T left, const tcomplex& right)
 	{
-		return complex(left * right.m_re, left * right.m_im);
+		return tcomplex(left * right.m_re, left * right.m_im);
 	}
 
-	friend complex operator/ (const double left, const complex& right)
+	friend tcomplex operator/ (const T left, const tcomplex& right)
 	{
-		const double denominator = right.m_re * right.m_re + right.m_im * right.m_im;
-		return complex(left * right.m_re / denominator,
+		const T denominator = right.m_re * right.m_re + right.m_im * right.m_im;
+		return tcomplex(left * right.m_re / denominator,
 			-left * right.m_im / denominator);
 	}
 
 	//   Boolean operators
-	bool operator== (const complex &other) const
+	bool operator== (const tcomplex &other) const
 	{
 		return m_re == other.m_re && m_im == other.m_im;
 	}
 
-	bool operator!= (const complex &other) const
+	bool operator!= (const tcomplex &other) const
 	{
 		return m_re != other.m_re || m_im != other.m_im;
 	}
 
-	bool operator== (const double val) const
+	bool operator== (const T val) const
 	{
-		return m_re == val && m_im == 0.;
+		return m_re == val && m_im == 0;
 	}
 
-	bool operator!= (const double val) const
+	bool operator!= (const T val) const
 	{
-		return m_re != val || m_im != 0.;
+		return m_re != val || m_im != 0;
 	}
 
-	friend bool operator== (const double left, const complex& right)
+	friend bool operator== (const T left, const tcomplex& right)
 	{
-		return left == right.m_re && right.m_im == 0.;
+		return left == right.m_re && right.m_im == 0;
 	}
 
-	friend bool operator!= (const double left, const complex& right)
+	friend bool operator!= (const T left, const tcomplex& right)
 	{
-		return left != right.m_re || right.m_im != 0.;
+		return left != right.m_re || right.m_im != 0;
 	}
 };
 
+//   Imaginary unity constants
+template <typename T>
+const tcomplex<T> tcomplex<T>::i(0, 1);
+template <typename T>
+const tcomplex<T> tcomplex<T>::j(0, 1);
+
+//   Double and single precision complex numbers
+typedef tcomplex<double> complex;
+typedef tcomplex<float> fcomplex;
+
 #endif
\ No newline at end of file
@@ -7,38 +7,110 @@
 
 //   Include declaration file
 #include "fft.h"
+//   Include vectorized kernels
+#include "fftsimd.h"
 //   Include math library
 #include <math.h>
 
+//   Vectorized kernels treat complex as pair of real numbers
+static_assert(sizeof(complex) == 2 * sizeof(double), "complex must be two doubles");
+static_assert(sizeof(fcomplex) == 2 * sizeof(float), "fcomplex must be two floats");
+
+//   Constructor
+//     N - transform length, power of 2
+template <typename T>
+CFFTPlan<T>::CFFTPlan(const unsigned int N): m_N(0), m_Reverse(0), m_Factor(0), m_Pack(0),
+	m_Kernels(FFTKernels<T>())
+{
+	//   Check input parameters
+	if (N < 1 || N & (N - 1))
+		return;
+	m_N = N;
+	//   Bit reversal permutation
+	m_Reverse = new unsigned int[N];
+	//   Data entry position
+	unsigned int Target = 0;
+	//   Process all positions of input signal
+	for (unsigned int Position = 0; Position < N; ++Position)
+	{
+		//   Save data entry
+		m_Reverse[Position] = Target;
+		//   Bit mask
+		unsigned int Mask = N;
+		//   While bit is set
+		while (Target & (Mask >>= 1))
+			//   Drop bit
+			Target &= ~Mask;
+		//   The current bit is 0 - set it
+		Target |= Mask;
+	}
+	//   Transform factors, every one computed directly
+	//   to avoid error accumulated by trigonometric recurrence,
+	//   tables of Step start at 3 * (Step - 1) and serve every length up to N
+	m_Factor = new complex[N < 4 ? 0 : 3 * ((N >> 1) - 1)];
+	for (unsigned int Step = 1; (Step << 2) <= N; Step <<= 1)
+	{
+		complex *const Factor = m_Factor + 3 * (Step - 1);
+		for (unsigned int Group = 0; Group < Step; ++Group)
+		{
+			const double fi = -2. * 3.14159265358979323846 * double(Group) / double(Step << 2);
+			Factor[Group] = complex(T(cos(fi)), T(sin(fi)));
+			Factor[Group + Step] = complex(T(cos(2. * fi)), T(sin(2. * fi)));
+			Factor[Group + 2 * Step] = complex(T(cos(3. * fi)), T(sin(3. * fi)));
+		}
+	}
+	m_Pack = new complex[(N >> 2) + 1];
+	for (unsigned int Position = 0; Position <= (N >> 2); ++Position)
+	{
+		const double fi = 2. * 3.14159265358979323846 * double(Position) / double(N);
+		m_Pack[Position] = complex(T(cos(fi)), T(sin(fi)));
+	}
+}
+
+template <typename T>
+CFFTPlan<T>::~CFFTPlan()
+{
+	delete[] m_Reverse;
+	delete[] m_Factor;
+	delete[] m_Pack;
+}
+
+//   Instruction set of vectorized kernels, "none" if not used
+template <typename T>
+const char *CFFTPlan<T>::Backend() const
+{
+	return m_Kernels ? m_Kernels->Name : "none";
+}
+
 //   FORWARD FOURIER TRANSFORM
 //     Input  - input data
 //     Output - transform result
-//     N      - length of both input data and result
-bool CFFT::Forward(const complex *const Input, complex *const Output, const unsigned int N)
+template <typename T>
+bool CFFTPlan<T>::Forward(const complex *const Input, complex *const Output) const
 {
 	//   Check input parameters
-	if (!Input || !Output || N < 1 || N & (N - 1))
+	if (!Input || !Output || !m_N)
 		return false;
 	//   Initialize data
-	Rearrange(Input, Output, N);
+	Rearrange(Input, Output, m_N);
 	//   Call FFT implementation
-	Perform(Output, N);
+	Perform(Output, m_N);
 	//   Succeeded
 	return true;
 }
 
 //   FORWARD FOURIER TRANSFORM, INPLACE VERSION
 //     Data - both input data and output
-//     N    - length of input data
-bool CFFT::Forward(complex *const Data, const unsigned int N)
+template <typename T>
+bool CFFTPlan<T>::Forward(complex *const Data) const
 {
 	//   Check input parameters
-	if (!Data || N < 1 || N & (N - 1))
+	if (!Data || !m_N)
 		return false;
 	//   Rearrange
-	Rearrange(Data, N);
+	Rearrange(Data, m_N);
 	//   Call FFT implementation
-	Perform(Data, N);
+	Perform(Data, m_N);
 	//   Succeeded
 	return true;
 }
@@ -46,73 +118,125 @@ bool CFFT::Forward(complex *const Data, const unsigned int N)
 //   INVERSE FOURIER TRANSFORM
 //     Input  - input data
 //     Output - transform result
-//     N      - length of both input data and result
 //     Scale  - if to scale result
-bool CFFT::Inverse(const complex *const Input, complex *const Output, const unsigned int N, const bool Scale /* = true */)
+template <typename T>
+bool CFFTPlan<T>::Inverse(const complex *const Input, complex *const Output, const bool Scale /* = true */) const
 {
 	//   Check input parameters
-	if (!Input || !Output || N < 1 || N & (N - 1))
+	if (!Input || !Output || !m_N)
 		return false;
 	//   Initialize data
-	Rearrange(Input, Output, N);
+	Rearrange(Input, Output, m_N);
 	//   Call FFT implementation
-	Perform(Output, N, true);
+	Perform(Output, m_N, true);
 	//   Scale if necessary
 	if (Scale)
-		CFFT::Scale(Output, N);
+		CFFTPlan<T>::Scale(Output, m_N);
 	//   Succeeded
 	return true;
 }
 
 //   INVERSE FOURIER TRANSFORM, INPLACE VERSION
 //     Data  - both input data and output
-//     N     - length of both input data and result
 //     Scale - if to scale result
-bool CFFT::Inverse(complex *const Data, const unsigned int N, const bool Scale /* = true */)
+template <typename T>
+bool CFFTPlan<T>::Inverse(complex *const Data, const bool Scale /* = true */) const
 {
 	//   Check input parameters
-	if (!Data || N < 1 || N & (N - 1))
+	if (!Data || !m_N)
+		return false;
+	//   Rearrange
+	Rearrange(Data, m_N);
+	//   Call FFT implementation
+	Perform(Data, m_N, true);
+	//   Scale if necessary
+	if (Scale)
+		CFFTPlan<T>::Scale(Data, m_N);
+	//   Succeeded
+	return true;
+}
+
+//   INVERSE FOURIER TRANSFORM OF HERMITIAN DATA, REAL RESULT
+//     Data   - first N / 2 + 1 entries of hermitian input data,
+//              used as work space and destroyed
+//     Output - real transform result
+//     Scale  - if to scale result
+template <typename T>
+bool CFFTPlan<T>::InverseReal(complex *const Data, T *const Output, const bool Scale /* = true */) const
+{
+	//   Check input parameters
+	if (!Data || !Output || m_N < 2)
 		return false;
+	//   Length of complex transform
+	const unsigned int Half = m_N >> 1;
+	//   Even and odd result entries as one complex sequence
+	Pack(Data);
 	//   Rearrange
-	Rearrange(Data, N);
+	Rearrange(Data, Half);
+	//   Call FFT implementation
+	Perform(Data, Half, true);
+	//   Unpack real result and scale if necessary
+	const T Factor = Scale ? T(1. / double(m_N)) : T(1);
+	for (unsigned int Position = 0; Position < Half; ++Position)
+	{
+		Output[Position << 1] = Data[Position].re() * Factor;
+		Output[(Position << 1) + 1] = Data[Position].im() * Factor;
+	}
+	//   Succeeded
+	return true;
+}
+
+//   INVERSE FOURIER TRANSFORM OF ADJACENT COLUMNS, INPLACE VERSION
+//     Data   - first entry of Count columns of length N, entry
+//              of row r and column c is Data[r * Stride + c]
+//     Stride - distance between rows in entries
+//     Count  - number of columns transformed together
+//     Scale  - if to scale result
+template <typename T>
+bool CFFTPlan<T>::InverseColumns(complex *const Data, const unsigned int Stride, const unsigned int Count, const bool Scale /* = true */) const
+{
+	//   Check input parameters
+	if (!Data || !m_N || Count > Stride)
+		return false;
+	//   Rearrange rows
+	RearrangeColumns(Data, Stride, Count);
 	//   Call FFT implementation
-	Perform(Data, N, true);
+	PerformColumns(Data, Stride, Count, true);
 	//   Scale if necessary
 	if (Scale)
-		CFFT::Scale(Data, N);
+	{
+		const T Factor = T(1. / double(m_N));
+		for (unsigned int Row = 0; Row < m_N; ++Row)
+			for (unsigned int Column = 0; Column < Count; ++Column)
+				Data[Row * Stride + Column] *= Factor;
+	}
 	//   Succeeded
 	return true;
 }
 
 //   Rearrange function
-void CFFT::Rearrange(const complex *const Input, complex *const Output, const unsigned int N)
+template <typename T>
+void CFFTPlan<T>::Rearrange(const complex *const Input, complex *const Output, const unsigned int N) const
 {
-	//   Data entry position
-	unsigned int Target = 0;
+	//   Permutation of length N is every (m_N / N)-th entry of the table
+	const unsigned int Stride = m_N / N;
 	//   Process all positions of input signal
 	for (unsigned int Position = 0; Position < N; ++Position)
-	{
 		//  Set data entry
-		Output[Target] = Input[Position];
-		//   Bit mask
-		unsigned int Mask = N;
-		//   While bit is set
-		while (Target & (Mask >>= 1))
-			//   Drop bit
-			Target &= ~Mask;
-		//   The current bit is 0 - set it
-		Target |= Mask;
-	}
+		Output[m_Reverse[Position * Stride]] = Input[Position];
 }
 
 //   Inplace version of rearrange function
-void CFFT::Rearrange(complex *const Data, const unsigned int N)
+template <typename T>
+void CFFTPlan<T>::Rearrange(complex *const Data, const unsigned int N) const
 {
-	//   Swap position
-	unsigned int Target = 0;
+	//   Permutation of length N is every (m_N / N)-th entry of the table
+	const unsigned int Stride = m_N / N;
 	//   Process all positions of input signal
 	for (unsigned int Position = 0; Position < N; ++Position)
 	{
+		//   Swap position
+		const unsigned int Target = m_Reverse[Position * Stride];
 		//   Only for not yet swapped entries
 		if (Target > Position)
 		{
@@ -121,60 +245,365 @@ void CFFT::Rearrange(complex *const Data, const unsigned int N)
 			Data[Target] = Data[Position];
 			Data[Position] = Temp;
 		}
-		//   Bit mask
-		unsigned int Mask = N;
-		//   While bit is set
-		while (Target & (Mask >>= 1))
-			//   Drop bit
-			Target &= ~Mask;
-		//   The current bit is 0 - set it
-		Target |= Mask;
 	}
 }
 
+//   Rearrange of rows for transform of columns
+template <typename T>
+void CFFTPlan<T>::RearrangeColumns(complex *const Data, const unsigned int Stride, const unsigned int Count) const
+{
+	//   Process all rows
+	for (unsigned int Position = 0; Position < m_N; ++Position)
+	{
+		//   Swap position
+		const unsigned int Target = m_Reverse[Position];
+		//   Only for not yet swapped rows
+		if (Target > Position)
+		{
+			//   Swap row entries
+			complex *const Row0 = Data + Position * Stride;
+			complex *const Row1 = Data + Target * Stride;
+			for (unsigned int Column = 0; Column < Count; ++Column)
+			{
+				const complex Temp(Row1[Column]);
+				Row1[Column] = Row0[Column];
+				Row0[Column] = Temp;
+			}
+		}
+	}
+}
+
+//   Packing of hermitian data into half length complex transform
+//     Z(k) = X(k) + X*(N/2 - k) + i * W^k * (X(k) - X*(N/2 - k)), W = exp(2 * pi * i / N)
+//   inverse transform of Z gives even result entries as real
+//   and odd result entries as imaginary parts
+template <typename T>
+void CFFTPlan<T>::Pack(complex *const Data) const
+{
+	const unsigned int Half = m_N >> 1;
+	//   Entries k and N/2 - k are computed together
+	for (unsigned int Low = 0; Low <= Half - Low; ++Low)
+	{
+		const unsigned int High = Half - Low;
+		//   Transform factor W^k
+		const complex Factor(m_Pack[Low]);
+		//   Sum and difference of entry and its hermitian pair
+		const complex Sum(Data[Low] + Data[High].conjugate());
+		const complex Difference(Data[Low] - Data[High].conjugate());
+		//   Entry k
+		Data[Low] = Sum + complex::i * Factor * Difference;
+		//   Entry N/2 - k, W^(N/2 - k) = -W*^k
+		if (High != Low && High != Half)
+			Data[High] = Sum.conjugate() + complex::i * Factor.conjugate() * Difference.conjugate();
+	}
+}
+
+//   Multiplication by -i for forward and by i for inverse transform
+template <typename T>
+static inline tcomplex<T> Rotate(const tcomplex<T>& Value, const bool Inverse)
+{
+	return Inverse ? tcomplex<T>(-Value.im(), Value.re()) : tcomplex<T>(Value.im(), -Value.re());
+}
+
 //   FFT implementation
-void CFFT::Perform(complex *const Data, const unsigned int N, const bool Inverse /* = false */)
-{
-	const double pi = Inverse ? 3.14159265358979323846 : -3.14159265358979323846;
-	//   Iteration through dyads, quadruples, octads and so on...
-	for (unsigned int Step = 1; Step < N; Step <<= 1)
-	{
-		//   Jump to the next entry of the same transform factor
-		const unsigned int Jump = Step << 1;
-		//   Angle increment
-		const double delta = pi / double(Step);
-		//   Auxiliary sin(delta / 2)
-		const double Sine = sin(delta * .5);
-		//   Multiplier for trigonometric recurrence
-		const complex Multiplier(-2. * Sine * Sine, sin(delta));
-		//   Start value for transform factor, fi = 0
-		complex Factor(1.);
+template <typename T>
+void CFFTPlan<T>::Perform(complex *const Data, const unsigned int N, const bool Inverse /* = false */) const
+{
+	if (N < 2)
+		return;
+	//   Number of stages
+	unsigned int Stages = 0;
+	while ((1u << Stages) < N)
+		++Stages;
+	//   Vectorized kernels work on interleaved real and imaginary parts
+	if (m_Kernels)
+	{
+		T *const Entries = reinterpret_cast<T*>(Data);
+		unsigned int Step;
+		if (Stages & 1)
+		{
+			m_Kernels->First2(Entries, N);
+			Step = 2;
+		}
+		else
+		{
+			m_Kernels->First4(Entries, N, Inverse);
+			Step = 4;
+		}
+		for (; Step < N; Step <<= 2)
+			m_Kernels->Pass4(Entries, N, Step, reinterpret_cast<const T*>(m_Factor + 3 * (Step - 1)), Inverse);
+		return;
+	}
+	//   First pass works on dyads or quadruples with unit transform factors
+	unsigned int Step;
+	if (Stages & 1)
+	{
+		Perform2(Data, N);
+		Step = 2;
+	}
+	else
+	{
+		Perform4(Data, N, Inverse);
+		Step = 4;
+	}
+	//   Every next pass joins four transforms of length Step
+	for (; Step < N; Step <<= 2)
+		Perform4(Data, N, Step, Inverse);
+}
+
+//   First radix-2 pass, transform factor is 1
+template <typename T>
+void CFFTPlan<T>::Perform2(complex *const Data, const unsigned int N)
+{
+	for (unsigned int Pair = 0; Pair < N; Pair += 2)
+	{
+		const complex Product(Data[Pair + 1]);
+		//   Transform for fi + pi
+		Data[Pair + 1] = Data[Pair] - Product;
+		//   Transform for fi
+		Data[Pair] += Product;
+	}
+}
+
+//   First radix-4 pass, transform factors are 1
+template <typename T>
+void CFFTPlan<T>::Perform4(complex *const Data, const unsigned int N, const bool Inverse)
+{
+	for (unsigned int Quad = 0; Quad < N; Quad += 4)
+	{
+		const complex Sum0(Data[Quad] + Data[Quad + 1]);
+		const complex Difference0(Data[Quad] - Data[Quad + 1]);
+		const complex Sum1(Data[Quad + 2] + Data[Quad + 3]);
+		const complex Difference1(Rotate(Data[Quad + 2] - Data[Quad + 3], Inverse));
+		Data[Quad] = Sum0 + Sum1;
+		Data[Quad + 1] = Difference0 + Difference1;
+		Data[Quad + 2] = Sum0 - Sum1;
+		Data[Quad + 3] = Difference0 - Difference1;
+	}
+}
+
+//   Radix-4 pass, joins transforms of length Step at positions
+//   q, q + Step, q + 2 * Step and q + 3 * Step into one of length 4 * Step
+//   what makes two radix-2 stages with 3 complex multiplications
+//   instead of 4 and one pass over the data instead of 2
+template <typename T>
+void CFFTPlan<T>::Perform4(complex *const Data, const unsigned int N, const unsigned int Step, const bool Inverse) const
+{
+	//   Jump to the next quadruple of transforms
+	const unsigned int Jump = Step << 2;
+	//   Transform factors of this pass
+	const complex *const Factor = m_Factor + 3 * (Step - 1);
+	for (unsigned int Quad = 0; Quad < N; Quad += Jump)
+	{
+		complex *const Entry = Data + Quad;
 		//   Iteration through groups of different transform factor
 		for (unsigned int Group = 0; Group < Step; ++Group)
 		{
-			//   Iteration within group 
-			for (unsigned int Pair = Group; Pair < N; Pair += Jump)
+			//   Transform factors w^g, w^2g and w^3g, conjugate for inverse transform
+			complex Factor1(Factor[Group]), Factor2(Factor[Group + Step]), Factor3(Factor[Group + 2 * Step]);
+			if (Inverse)
 			{
-				//   Match position
-				const unsigned int Match = Pair + Step;
-				//   Second term of two-point transform
-				const complex Product(Factor * Data[Match]);
-				//   Transform for fi + pi
-				Data[Match] = Data[Pair] - Product;
-				//   Transform for fi
-				Data[Pair] += Product;
+				Factor1 = Factor1.conjugate();
+				Factor2 = Factor2.conjugate();
+				Factor3 = Factor3.conjugate();
 			}
-			//   Successive transform factor via trigonometric recurrence
-			Factor = Multiplier * Factor + Factor;
+			const complex A(Entry[Group]);
+			const complex B(Factor2 * Entry[Group + Step]);
+			const complex C(Factor1 * Entry[Group + 2 * Step]);
+			const complex D(Factor3 * Entry[Group + 3 * Step]);
+			const complex Sum0(A + B), Difference0(A - B);
+			const complex Sum1(C + D), Difference1(Rotate(C - D, Inverse));
+			Entry[Group] = Sum0 + Sum1;
+			Entry[Group + Step] = Difference0 + Difference1;
+			Entry[Group + 2 * Step] = Sum0 - Sum1;
+			Entry[Group + 3 * Step] = Difference0 - Difference1;
 		}
 	}
 }
 
+//   FFT of columns, passes are the same as in Perform, but every butterfly
+//   joins whole rows, so inner loops run over adjacent entries of memory
+//   with one transform factor; first radix-4 pass is the pass of Step 1,
+//   which factors are all 1
+template <typename T>
+void CFFTPlan<T>::PerformColumns(complex *const Data, const unsigned int Stride, const unsigned int Count, const bool Inverse) const
+{
+	const unsigned int N = m_N;
+	if (N < 2)
+		return;
+	//   Number of stages
+	unsigned int Stages = 0;
+	while ((1u << Stages) < N)
+		++Stages;
+	//   Vectorized kernels work on interleaved real and imaginary parts
+	if (m_Kernels)
+	{
+		T *const Entries = reinterpret_cast<T*>(Data);
+		unsigned int Step = 1;
+		if (Stages & 1)
+		{
+			m_Kernels->Columns2(Entries, N, Stride, Count);
+			Step = 2;
+		}
+		for (; Step < N; Step <<= 2)
+			m_Kernels->Columns4(Entries, N, Stride, Count, Step, reinterpret_cast<const T*>(m_Factor + 3 * (Step - 1)), Inverse);
+		return;
+	}
+	//   First radix-2 pass with unit transform factors
+	unsigned int Step = 1;
+	if (Stages & 1)
+	{
+		for (unsigned int Pair = 0; Pair < N; Pair += 2)
+		{
+			complex *const Row0 = Data + Pair * Stride;
+			complex *const Row1 = Row0 + Stride;
+			for (unsigned int Column = 0; Column < Count; ++Column)
+			{
+				const complex Product(Row1[Column]);
+				Row1[Column] = Row0[Column] - Product;
+				Row0[Column] += Product;
+			}
+		}
+		Step = 2;
+	}
+	//   Every next pass joins four transforms of length Step
+	for (; Step < N; Step <<= 2)
+	{
+		const unsigned int Jump = Step << 2;
+		const complex *const Factor = m_Factor + 3 * (Step - 1);
+		for (unsigned int Quad = 0; Quad < N; Quad += Jump)
+			for (unsigned int Group = 0; Group < Step; ++Group)
+			{
+				//   Transform factors w^g, w^2g and w^3g, conjugate for inverse transform
+				complex Factor1(Factor[Group]), Factor2(Factor[Group + Step]), Factor3(Factor[Group + 2 * Step]);
+				if (Inverse)
+				{
+					Factor1 = Factor1.conjugate();
+					Factor2 = Factor2.conjugate();
+					Factor3 = Factor3.conjugate();
+				}
+				complex *const Row0 = Data + (Quad + Group) * Stride;
+				complex *const Row1 = Row0 + Step * Stride;
+				complex *const Row2 = Row1 + Step * Stride;
+				complex *const Row3 = Row2 + Step * Stride;
+				for (unsigned int Column = 0; Column < Count; ++Column)
+				{
+					const complex A(Row0[Column]);
+					const complex B(Factor2 * Row1[Column]);
+					const complex C(Factor1 * Row2[Column]);
+					const complex D(Factor3 * Row3[Column]);
+					const complex Sum0(A + B), Difference0(A - B);
+					const complex Sum1(C + D), Difference1(Rotate(C - D, Inverse));
+					Row0[Column] = Sum0 + Sum1;
+					Row1[Column] = Difference0 + Difference1;
+					Row2[Column] = Sum0 - Sum1;
+					Row3[Column] = Difference0 - Difference1;
+				}
+			}
+	}
+}
+
 //   Scaling of inverse FFT result
-void CFFT::Scale(complex *const Data, const unsigned int N)
+template <typename T>
+void CFFTPlan<T>::Scale(complex *const Data, const unsigned int N)
 {
-	const double Factor = 1. / double(N);
+	const T Factor = T(1. / double(N));
 	//   Scale all data entries
 	for (unsigned int Position = 0; Position < N; ++Position)
 		Data[Position] *= Factor;
 }
+
+//   FORWARD FOURIER TRANSFORM
+//     Input  - input data
+//     Output - transform result
+//     N      - length of both input data and result
+template <typename T>
+bool CFFT<T>::Forward(const complex *const Input, complex *const Output, const unsigned int N)
+{
+	//   Check input parameters
+	if (!Input || !Output || N < 1 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).Forward(Input, Output);
+}
+
+//   FORWARD FOURIER TRANSFORM, INPLACE VERSION
+//     Data - both input data and output
+//     N    - length of input data
+template <typename T>
+bool CFFT<T>::Forward(complex *const Data, const unsigned int N)
+{
+	//   Check input parameters
+	if (!Data || N < 1 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).Forward(Data);
+}
+
+//   INVERSE FOURIER TRANSFORM
+//     Input  - input data
+//     Output - transform result
+//     N      - length of both input data and result
+//     Scale  - if to scale result
+template <typename T>
+bool CFFT<T>::Inverse(const complex *const Input, complex *const Output, const unsigned int N, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Input || !Output || N < 1 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).Inverse(Input, Output, Scale);
+}
+
+//   INVERSE FOURIER TRANSFORM, INPLACE VERSION
+//     Data  - both input data and output
+//     N     - length of both input data and result
+//     Scale - if to scale result
+template <typename T>
+bool CFFT<T>::Inverse(complex *const Data, const unsigned int N, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Data || N < 1 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).Inverse(Data, Scale);
+}
+
+//   INVERSE FOURIER TRANSFORM OF HERMITIAN DATA, REAL RESULT
+//     Data   - first N / 2 + 1 entries of hermitian input data,
+//              used as work space and destroyed
+//     Output - real transform result
+//     N      - length of result
+//     Scale  - if to scale result
+template <typename T>
+bool CFFT<T>::InverseReal(complex *const Data, T *const Output, const unsigned int N, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Data || !Output || N < 2 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).InverseReal(Data, Output, Scale);
+}
+
+//   INVERSE FOURIER TRANSFORM OF ADJACENT COLUMNS, INPLACE VERSION
+//     Data   - first entry of Count columns of length N, entry
+//              of row r and column c is Data[r * Stride + c]
+//     N      - length of columns
+//     Stride - distance between rows in entries
+//     Count  - number of columns transformed together
+//     Scale  - if to scale result
+template <typename T>
+bool CFFT<T>::InverseColumns(complex *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Data || N < 1 || N & (N - 1))
+		return false;
+	//   Call plan implementation
+	return CFFTPlan<T>(N).InverseColumns(Data, Stride, Count, Scale);
+}
+
+//   Double and single precision transforms
+template class CFFTPlan<double>;
+template class CFFTPlan<float>;
+template class CFFT<double>;
+template class CFFT<float>;
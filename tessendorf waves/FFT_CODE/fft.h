@@ -11,9 +11,118 @@
 //   Include complex numbers header
 #include "complex.h"
 
+template <typename T>
+struct CFFTKernels;
+
+//   Transform plan - tables for repeated transforms of the same length
+//     T - float or double
+template <typename T>
+class CFFTPlan
+{
+public:
+	//   Complex numbers of plan precision
+	typedef tcomplex<T> complex;
+
+	//   Constructor
+	//     N - transform length, power of 2
+	explicit CFFTPlan(const unsigned int N);
+	~CFFTPlan();
+
+	//   Transform length, 0 if plan is not valid
+	unsigned int Length() const { return m_N; }
+
+	//   Instruction set of vectorized kernels, "none" if not used
+	const char *Backend() const;
+
+	//   FORWARD FOURIER TRANSFORM
+	//     Input  - input data
+	//     Output - transform result
+	bool Forward(const complex *const Input, complex *const Output) const;
+
+	//   FORWARD FOURIER TRANSFORM, INPLACE VERSION
+	//     Data - both input data and output
+	bool Forward(complex *const Data) const;
+
+	//   INVERSE FOURIER TRANSFORM
+	//     Input  - input data
+	//     Output - transform result
+	//     Scale  - if to scale result
+	bool Inverse(const complex *const Input, complex *const Output, const bool Scale = true) const;
+
+	//   INVERSE FOURIER TRANSFORM, INPLACE VERSION
+	//     Data  - both input data and output
+	//     Scale - if to scale result
+	bool Inverse(complex *const Data, const bool Scale = true) const;
+
+	//   INVERSE FOURIER TRANSFORM OF HERMITIAN DATA, REAL RESULT
+	//     Data   - first N / 2 + 1 entries of hermitian input data,
+	//              used as work space and destroyed
+	//     Output - real transform result
+	//     Scale  - if to scale result
+	bool InverseReal(complex *const Data, T *const Output, const bool Scale = true) const;
+
+	//   INVERSE FOURIER TRANSFORM OF ADJACENT COLUMNS, INPLACE VERSION
+	//     Data   - first entry of Count columns of length N, entry
+	//              of row r and column c is Data[r * Stride + c]
+	//     Stride - distance between rows in entries
+	//     Count  - number of columns transformed together
+	//     Scale  - if to scale result
+	bool InverseColumns(complex *const Data, const unsigned int Stride, const unsigned int Count, const bool Scale = true) const;
+
+protected:
+	//   Rearrange function and its inplace version,
+	//   N may be any power of 2 up to plan length
+	void Rearrange(const complex *const Input, complex *const Output, const unsigned int N) const;
+	void Rearrange(complex *const Data, const unsigned int N) const;
+
+	//   Rearrange of rows for transform of columns
+	void RearrangeColumns(complex *const Data, const unsigned int Stride, const unsigned int Count) const;
+
+	//   Packing of hermitian data into half length complex transform
+	void Pack(complex *const Data) const;
+
+	//   FFT implementation, radix-4 passes with one radix-2 pass
+	//   if number of stages is odd
+	void Perform(complex *const Data, const unsigned int N, const bool Inverse = false) const;
+	//   First pass - radix-2 or radix-4 without transform factors
+	static void Perform2(complex *const Data, const unsigned int N);
+	static void Perform4(complex *const Data, const unsigned int N, const bool Inverse);
+	//   Radix-4 pass combining transforms of length Step
+	void Perform4(complex *const Data, const unsigned int N, const unsigned int Step, const bool Inverse) const;
+	//   FFT of columns, the same passes with every butterfly applied
+	//   to whole rows, so transform factor is shared by Count entries
+	void PerformColumns(complex *const Data, const unsigned int Stride, const unsigned int Count, const bool Inverse) const;
+
+	//   Scaling of inverse FFT result
+	static void Scale(complex *const Data, const unsigned int N);
+
+	//   Transform length
+	unsigned int m_N;
+	//   Bit reversal permutation
+	unsigned int *m_Reverse;
+	//   Transform factors of radix-4 passes, for every pass of Step
+	//   three arrays of w^g, w^2g, w^3g, w = exp(-2 * pi * i / (4 * Step)), g < Step
+	complex *m_Factor;
+	//   Factors of real transform exp(2 * pi * i * k / N), k <= N / 4
+	complex *m_Pack;
+	//   Vectorized kernels selected for this processor, 0 if none
+	const CFFTKernels<T> *m_Kernels;
+
+private:
+	CFFTPlan(const CFFTPlan&) = delete;
+	CFFTPlan& operator= (const CFFTPlan&) = delete;
+};
+
+//   One-off transforms, tables are prepared on every call,
+//   use CFFTPlan for repeated transforms of the same length
+//     T - float or double
+template <typename T>
 class CFFT
 {
 public:
+	//   Complex numbers of transform precision
+	typedef tcomplex<T> complex;
+
 	//   FORWARD FOURIER TRANSFORM
 	//     Input  - input data
 	//     Output - transform result
@@ -38,16 +147,22 @@ public:
 	//     Scale - if to scale result
 	static bool Inverse(complex *const Data, const unsigned int N, const bool Scale = true);
 
-protected:
-	//   Rearrange function and its inplace version
-	static void Rearrange(const complex *const Input, complex *const Output, const unsigned int N);
-	static void Rearrange(complex *const Data, const unsigned int N);
-
-	//   FFT implementation
-	static void Perform(complex *const Data, const unsigned int N, const bool Inverse = false);
+	//   INVERSE FOURIER TRANSFORM OF HERMITIAN DATA, REAL RESULT
+	//     Data   - first N / 2 + 1 entries of hermitian input data,
+	//              used as work space and destroyed
+	//     Output - real transform result
+	//     N      - length of result
+	//     Scale  - if to scale result
+	static bool InverseReal(complex *const Data, T *const Output, const unsigned int N, const bool Scale = true);
 
-	//   Scaling of inverse FFT result
-	static void Scale(complex *const Data, const unsigned int N);
+	//   INVERSE FOURIER TRANSFORM OF ADJACENT COLUMNS, INPLACE VERSION
+	//     Data   - first entry of Count columns of length N, entry
+	//              of row r and column c is Data[r * Stride + c]
+	//     N      - length of columns
+	//     Stride - distance between rows in entries
+	//     Count  - number of columns transformed together
+	//     Scale  - if to scale result
+	static bool InverseColumns(complex *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count, const bool Scale = true);
 };
 
 #endif
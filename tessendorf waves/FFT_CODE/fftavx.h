@@ -0,0 +1,125 @@
+//   fftavx.h - register types of AVX2 and FMA instruction sets,
+//   shared by fftavx2.cpp and fftavx512.cpp
+//
+//   Every including file gets its own copy in unnamed namespace,
+//   so no code compiled for wider instruction set is shared
+
+#ifndef _FFTAVX_H_
+#define _FFTAVX_H_
+
+#include <immintrin.h>
+
+namespace
+{
+	//   One double complex entry
+	struct D1
+	{
+		typedef double T;
+		typedef __m128d R;
+		static const unsigned int Width = 1;
+
+		static R Load(const T *const Data) { return _mm_loadu_pd(Data); }
+		static void Store(T *const Data, const R Value) { _mm_storeu_pd(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_pd(Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_pd(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_pd(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_pd(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_permute_pd(A, 1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm_fmaddsub_pd(A, _mm_movedup_pd(B), _mm_mul_pd(Swap(A), _mm_permute_pd(B, 3)));
+		}
+	};
+
+	//   Two double complex entries
+	struct D2
+	{
+		typedef double T;
+		typedef __m256d R;
+		static const unsigned int Width = 2;
+
+		static R Load(const T *const Data) { return _mm256_loadu_pd(Data); }
+		static void Store(T *const Data, const R Value) { _mm256_storeu_pd(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm256_setr_pd(Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm256_add_pd(A, B); }
+		static R Sub(const R A, const R B) { return _mm256_sub_pd(A, B); }
+		static R Xor(const R A, const R B) { return _mm256_xor_pd(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm256_permute_pd(A, 5); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm256_fmaddsub_pd(A, _mm256_movedup_pd(B), _mm256_mul_pd(Swap(A), _mm256_permute_pd(B, 15)));
+		}
+	};
+
+	//   One float complex entry in lower half of register
+	struct F1
+	{
+		typedef float T;
+		typedef __m128 R;
+		static const unsigned int Width = 1;
+
+		static R Load(const T *const Data) { return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(Data)); }
+		static void Store(T *const Data, const R Value) { _mm_storel_pi(reinterpret_cast<__m64*>(Data), Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_ps(Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_ps(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_ps(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_permute_ps(A, 0xB1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm_fmaddsub_ps(A, _mm_moveldup_ps(B), _mm_mul_ps(Swap(A), _mm_movehdup_ps(B)));
+		}
+	};
+
+	//   Two float complex entries
+	struct F2
+	{
+		typedef float T;
+		typedef __m128 R;
+		static const unsigned int Width = 2;
+
+		static R Load(const T *const Data) { return _mm_loadu_ps(Data); }
+		static void Store(T *const Data, const R Value) { _mm_storeu_ps(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_ps(Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_ps(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_ps(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_permute_ps(A, 0xB1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm_fmaddsub_ps(A, _mm_moveldup_ps(B), _mm_mul_ps(Swap(A), _mm_movehdup_ps(B)));
+		}
+	};
+
+	//   Four float complex entries
+	struct F4
+	{
+		typedef float T;
+		typedef __m256 R;
+		static const unsigned int Width = 4;
+
+		static R Load(const T *const Data) { return _mm256_loadu_ps(Data); }
+		static void Store(T *const Data, const R Value) { _mm256_storeu_ps(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm256_setr_ps(Re, Im, Re, Im, Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm256_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm256_sub_ps(A, B); }
+		static R Xor(const R A, const R B) { return _mm256_xor_ps(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm256_permute_ps(A, 0xB1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm256_fmaddsub_ps(A, _mm256_moveldup_ps(B), _mm256_mul_ps(Swap(A), _mm256_movehdup_ps(B)));
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,64 @@
+//   fftavx2.cpp - FFT kernels for AVX2 and FMA instruction sets,
+//   two double or four float complex entries per register
+//
+//   Compiled with AVX2 code generation, called only
+//   when processor supports it
+
+#include "fftsimd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#include "fftavx.h"
+#include "fftkernel.h"
+
+namespace
+{
+	void Pass4(double *const Data, const unsigned int N, const unsigned int Step,
+		const double *const Factor, const bool Inverse)
+	{
+		KernelPass4<D2>(Data, N, Step, Factor, Inverse);
+	}
+
+	//   Passes shorter than register width use half registers
+	void Pass4(float *const Data, const unsigned int N, const unsigned int Step,
+		const float *const Factor, const bool Inverse)
+	{
+		if (Step >= F4::Width)
+			KernelPass4<F4>(Data, N, Step, Factor, Inverse);
+		else
+			KernelPass4<F2>(Data, N, Step, Factor, Inverse);
+	}
+
+	const CFFTKernels<double> Kernels = { "AVX2", KernelFirst2<D1>, KernelFirst4<D1>, Pass4,
+		KernelColumns2<D2, D1>, KernelColumns4<D2, D1> };
+	const CFFTKernels<float> FloatKernels = { "AVX2", KernelFirst2<F1>, KernelFirst4<F1>, Pass4,
+		KernelColumns2<F4, F1>, KernelColumns4<F4, F1> };
+}
+
+template <>
+const CFFTKernels<double> *FFTKernelsAVX2<double>()
+{
+	return &Kernels;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsAVX2<float>()
+{
+	return &FloatKernels;
+}
+
+#else
+
+template <>
+const CFFTKernels<double> *FFTKernelsAVX2<double>()
+{
+	return 0;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsAVX2<float>()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,121 @@
+//   fftavx512.cpp - FFT kernels for AVX-512 instruction set,
+//   four double or eight float complex entries per register
+//
+//   Compiled with AVX-512 code generation, called only
+//   when processor supports it
+
+#include "fftsimd.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include "fftavx.h"
+#include "fftkernel.h"
+
+namespace
+{
+	//   Four double complex entries
+	struct D4
+	{
+		typedef double T;
+		typedef __m512d R;
+		static const unsigned int Width = 4;
+
+		static R Load(const T *const Data) { return _mm512_loadu_pd(Data); }
+		static void Store(T *const Data, const R Value) { _mm512_storeu_pd(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm512_setr_pd(Re, Im, Re, Im, Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm512_add_pd(A, B); }
+		static R Sub(const R A, const R B) { return _mm512_sub_pd(A, B); }
+		//   AVX-512F has no floating point xor, use integer one
+		static R Xor(const R A, const R B)
+		{
+			return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(A), _mm512_castpd_si512(B)));
+		}
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm512_permute_pd(A, 0x55); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm512_fmaddsub_pd(A, _mm512_movedup_pd(B), _mm512_mul_pd(Swap(A), _mm512_permute_pd(B, 0xFF)));
+		}
+	};
+
+	//   Eight float complex entries
+	struct F8
+	{
+		typedef float T;
+		typedef __m512 R;
+		static const unsigned int Width = 8;
+
+		static R Load(const T *const Data) { return _mm512_loadu_ps(Data); }
+		static void Store(T *const Data, const R Value) { _mm512_storeu_ps(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm512_broadcast_f32x4(_mm_setr_ps(Re, Im, Re, Im)); }
+		static R Add(const R A, const R B) { return _mm512_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm512_sub_ps(A, B); }
+		//   AVX-512F has no floating point xor, use integer one
+		static R Xor(const R A, const R B)
+		{
+			return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(A), _mm512_castps_si512(B)));
+		}
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm512_permute_ps(A, 0xB1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			return _mm512_fmaddsub_ps(A, _mm512_moveldup_ps(B), _mm512_mul_ps(Swap(A), _mm512_movehdup_ps(B)));
+		}
+	};
+
+	//   Passes shorter than register width fall back to AVX2 registers
+	void Pass4(double *const Data, const unsigned int N, const unsigned int Step,
+		const double *const Factor, const bool Inverse)
+	{
+		if (Step >= D4::Width)
+			KernelPass4<D4>(Data, N, Step, Factor, Inverse);
+		else
+			KernelPass4<D2>(Data, N, Step, Factor, Inverse);
+	}
+
+	void Pass4(float *const Data, const unsigned int N, const unsigned int Step,
+		const float *const Factor, const bool Inverse)
+	{
+		if (Step >= F8::Width)
+			KernelPass4<F8>(Data, N, Step, Factor, Inverse);
+		else if (Step >= F4::Width)
+			KernelPass4<F4>(Data, N, Step, Factor, Inverse);
+		else
+			KernelPass4<F2>(Data, N, Step, Factor, Inverse);
+	}
+
+	const CFFTKernels<double> Kernels = { "AVX-512", KernelFirst2<D1>, KernelFirst4<D1>, Pass4,
+		KernelColumns2<D4, D1>, KernelColumns4<D4, D1> };
+	const CFFTKernels<float> FloatKernels = { "AVX-512", KernelFirst2<F1>, KernelFirst4<F1>, Pass4,
+		KernelColumns2<F8, F1>, KernelColumns4<F8, F1> };
+}
+
+template <>
+const CFFTKernels<double> *FFTKernelsAVX512<double>()
+{
+	return &Kernels;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsAVX512<float>()
+{
+	return &FloatKernels;
+}
+
+#else
+
+template <>
+const CFFTKernels<double> *FFTKernelsAVX512<double>()
+{
+	return 0;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsAVX512<float>()
+{
+	return 0;
+}
+
+#endif
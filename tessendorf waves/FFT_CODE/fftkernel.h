@@ -0,0 +1,163 @@
+//   fftkernel.h - vectorized FFT passes, shared by instruction set
+//   specific files; V describes registers holding V::Width complex
+//   entries of type V::T and complex arithmetic on them
+//
+//   Only included by fftsse2.cpp, fftavx2.cpp and fftavx512.cpp,
+//   every one with its own V types in unnamed namespace
+
+#ifndef _FFTKERNEL_H_
+#define _FFTKERNEL_H_
+
+//   First radix-2 pass, transform factor is 1, V::Width must be 1
+template <class V>
+void KernelFirst2(typename V::T *const Data, const unsigned int N)
+{
+	typedef typename V::T T;
+	typedef typename V::R R;
+	for (unsigned int Pair = 0; Pair < N; Pair += 2)
+	{
+		T *const Entry = Data + 2 * Pair;
+		const R A = V::Load(Entry), B = V::Load(Entry + 2);
+		V::Store(Entry, V::Add(A, B));
+		V::Store(Entry + 2, V::Sub(A, B));
+	}
+}
+
+//   First radix-4 pass, transform factors are 1, V::Width must be 1
+template <class V>
+void KernelFirst4(typename V::T *const Data, const unsigned int N, const bool Inverse)
+{
+	typedef typename V::T T;
+	typedef typename V::R R;
+	//   Multiplication by -i for forward and by i for inverse transform
+	const R Rotate = Inverse ? V::Set(T(-0.), T(0)) : V::Set(T(0), T(-0.));
+	for (unsigned int Quad = 0; Quad < N; Quad += 4)
+	{
+		T *const Entry = Data + 2 * Quad;
+		const R A = V::Load(Entry), B = V::Load(Entry + 2);
+		const R C = V::Load(Entry + 4), D = V::Load(Entry + 6);
+		const R Sum0 = V::Add(A, B), Difference0 = V::Sub(A, B);
+		const R Sum1 = V::Add(C, D), Difference1 = V::Xor(V::Swap(V::Sub(C, D)), Rotate);
+		V::Store(Entry, V::Add(Sum0, Sum1));
+		V::Store(Entry + 2, V::Add(Difference0, Difference1));
+		V::Store(Entry + 4, V::Sub(Sum0, Sum1));
+		V::Store(Entry + 6, V::Sub(Difference0, Difference1));
+	}
+}
+
+//   Radix-4 butterfly of V::Width entries at Entry, Entry + Distance,
+//   Entry + 2 * Distance and Entry + 3 * Distance
+template <class V>
+inline void KernelButterfly4(typename V::T *const Entry, const unsigned int Distance,
+	const typename V::R Factor1, const typename V::R Factor2, const typename V::R Factor3, const typename V::R Rotate)
+{
+	typedef typename V::R R;
+	const R A = V::Load(Entry);
+	const R B = V::Mul(V::Load(Entry + Distance), Factor2);
+	const R C = V::Mul(V::Load(Entry + 2 * Distance), Factor1);
+	const R D = V::Mul(V::Load(Entry + 3 * Distance), Factor3);
+	const R Sum0 = V::Add(A, B), Difference0 = V::Sub(A, B);
+	const R Sum1 = V::Add(C, D), Difference1 = V::Xor(V::Swap(V::Sub(C, D)), Rotate);
+	V::Store(Entry, V::Add(Sum0, Sum1));
+	V::Store(Entry + Distance, V::Add(Difference0, Difference1));
+	V::Store(Entry + 2 * Distance, V::Sub(Sum0, Sum1));
+	V::Store(Entry + 3 * Distance, V::Sub(Difference0, Difference1));
+}
+
+//   Radix-4 pass, V::Width groups of one quadruple at once,
+//   Step must be multiple of V::Width
+template <class V>
+void KernelPass4(typename V::T *const Data, const unsigned int N, const unsigned int Step,
+	const typename V::T *const Factor, const bool Inverse)
+{
+	typedef typename V::T T;
+	typedef typename V::R R;
+	//   Conjugation of transform factors for inverse transform
+	const R Conjugate = Inverse ? V::Set(T(0), T(-0.)) : V::Set(T(0), T(0));
+	//   Multiplication by -i for forward and by i for inverse transform
+	const R Rotate = Inverse ? V::Set(T(-0.), T(0)) : V::Set(T(0), T(-0.));
+	const unsigned int Jump = Step << 2;
+	for (unsigned int Quad = 0; Quad < N; Quad += Jump)
+	{
+		T *const Entry = Data + 2 * Quad;
+		for (unsigned int Group = 0; Group < Step; Group += V::Width)
+		{
+			const unsigned int Position = 2 * Group;
+			const R Factor1 = V::Xor(V::Load(Factor + Position), Conjugate);
+			const R Factor2 = V::Xor(V::Load(Factor + Position + 2 * Step), Conjugate);
+			const R Factor3 = V::Xor(V::Load(Factor + Position + 4 * Step), Conjugate);
+			KernelButterfly4<V>(Entry + Position, 2 * Step, Factor1, Factor2, Factor3, Rotate);
+		}
+	}
+}
+
+//   First radix-2 pass of transform of columns, joins pairs of rows
+//   of Count entries, V::Width entries at once and the rest by V1
+template <class V, class V1>
+void KernelColumns2(typename V::T *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count)
+{
+	typedef typename V::T T;
+	for (unsigned int Pair = 0; Pair < N; Pair += 2)
+	{
+		T *const Row0 = Data + 2 * Pair * Stride;
+		T *const Row1 = Row0 + 2 * Stride;
+		unsigned int Column = 0;
+		for (; Column + V::Width <= Count; Column += V::Width)
+		{
+			const typename V::R A = V::Load(Row0 + 2 * Column), B = V::Load(Row1 + 2 * Column);
+			V::Store(Row0 + 2 * Column, V::Add(A, B));
+			V::Store(Row1 + 2 * Column, V::Sub(A, B));
+		}
+		for (; Column < Count; ++Column)
+		{
+			const typename V1::R A = V1::Load(Row0 + 2 * Column), B = V1::Load(Row1 + 2 * Column);
+			V1::Store(Row0 + 2 * Column, V1::Add(A, B));
+			V1::Store(Row1 + 2 * Column, V1::Sub(A, B));
+		}
+	}
+}
+
+//   Radix-4 pass of transform of columns, joins rows instead of entries,
+//   so every transform factor is broadcast to a whole row of Count entries,
+//   V::Width entries at once and the rest by V1, Step may be 1
+template <class V, class V1>
+void KernelColumns4(typename V::T *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count,
+	const unsigned int Step, const typename V::T *const Factor, const bool Inverse)
+{
+	typedef typename V::T T;
+	typedef typename V::R R;
+	typedef typename V1::R R1;
+	const T Sign = Inverse ? T(-1) : T(1);
+	const R Rotate = Inverse ? V::Set(T(-0.), T(0)) : V::Set(T(0), T(-0.));
+	const R1 Rotate1 = Inverse ? V1::Set(T(-0.), T(0)) : V1::Set(T(0), T(-0.));
+	const unsigned int Jump = Step << 2;
+	const unsigned int Distance = 2 * Step * Stride;
+	for (unsigned int Quad = 0; Quad < N; Quad += Jump)
+		for (unsigned int Group = 0; Group < Step; ++Group)
+		{
+			//   Transform factors w^g, w^2g and w^3g, conjugate for inverse transform
+			const T *const Factor1 = Factor + 2 * Group;
+			const T *const Factor2 = Factor1 + 2 * Step;
+			const T *const Factor3 = Factor2 + 2 * Step;
+			T *const Row = Data + 2 * (Quad + Group) * Stride;
+			unsigned int Column = 0;
+			if (Count >= V::Width)
+			{
+				const R Wide1 = V::Set(Factor1[0], Sign * Factor1[1]);
+				const R Wide2 = V::Set(Factor2[0], Sign * Factor2[1]);
+				const R Wide3 = V::Set(Factor3[0], Sign * Factor3[1]);
+				for (; Column + V::Width <= Count; Column += V::Width)
+					KernelButterfly4<V>(Row + 2 * Column, Distance, Wide1, Wide2, Wide3, Rotate);
+			}
+			if (Column < Count)
+			{
+				const R1 Narrow1 = V1::Set(Factor1[0], Sign * Factor1[1]);
+				const R1 Narrow2 = V1::Set(Factor2[0], Sign * Factor2[1]);
+				const R1 Narrow3 = V1::Set(Factor3[0], Sign * Factor3[1]);
+				for (; Column < Count; ++Column)
+					KernelButterfly4<V1>(Row + 2 * Column, Distance, Narrow1, Narrow2, Narrow3, Rotate1);
+			}
+		}
+}
+
+#endif
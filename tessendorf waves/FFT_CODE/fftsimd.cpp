@@ -0,0 +1,83 @@
+//   fftsimd.cpp - runtime selection of FFT kernels
+//   by instruction sets supported by processor and system
+
+#include "fftsimd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+//   CPUID instruction, Registers - EAX, EBX, ECX, EDX
+static void CpuId(const unsigned int Leaf, unsigned int Registers[4])
+{
+#if defined(_MSC_VER)
+	int Result[4];
+	__cpuidex(Result, int(Leaf), 0);
+	for (int Index = 0; Index < 4; ++Index)
+		Registers[Index] = (unsigned int)Result[Index];
+#else
+	__cpuid_count(Leaf, 0, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+}
+
+//   Register state enabled by system (XCR0)
+static unsigned long long EnabledState()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int Low, High;
+	__asm__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+	return ((unsigned long long)High << 32) | Low;
+#endif
+}
+
+//   Detection of best supported instruction set
+template <typename T>
+static const CFFTKernels<T> *Select()
+{
+	unsigned int Registers[4];
+	CpuId(0, Registers);
+	const unsigned int MaxLeaf = Registers[0];
+	CpuId(1, Registers);
+	//   AVX needs OSXSAVE, AVX and FMA flags and system saving of YMM state
+	const bool OSXSave = (Registers[2] & (1u << 27)) != 0;
+	const bool AVX = OSXSave && (Registers[2] & (1u << 28)) && (Registers[2] & (1u << 12))
+		&& (EnabledState() & 0x6) == 0x6;
+	if (AVX && MaxLeaf >= 7)
+	{
+		CpuId(7, Registers);
+		//   AVX-512F needs also system saving of opmask and ZMM state
+		if ((Registers[1] & (1u << 16)) && (EnabledState() & 0xE6) == 0xE6 && FFTKernelsAVX512<T>())
+			return FFTKernelsAVX512<T>();
+		if ((Registers[1] & (1u << 5)) && FFTKernelsAVX2<T>())
+			return FFTKernelsAVX2<T>();
+	}
+	//   SSE2 is part of every x64 processor and baseline of x86 build
+	return FFTKernelsSSE2<T>();
+}
+
+#else
+
+template <typename T>
+static const CFFTKernels<T> *Select()
+{
+	return 0;
+}
+
+#endif
+
+//   Best kernels supported by the processor, 0 if none
+template <typename T>
+const CFFTKernels<T> *FFTKernels()
+{
+	static const CFFTKernels<T> *const Kernels = Select<T>();
+	return Kernels;
+}
+
+template const CFFTKernels<double> *FFTKernels<double>();
+template const CFFTKernels<float> *FFTKernels<float>();
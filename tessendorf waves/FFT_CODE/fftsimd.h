@@ -0,0 +1,48 @@
+//   fftsimd.h - declaration of vectorized FFT kernels
+//   and runtime selection of instruction set
+//
+//   Kernels work on complex data as interleaved
+//   real and imaginary parts of type T, float or double
+
+#ifndef _FFTSIMD_H_
+#define _FFTSIMD_H_
+
+template <typename T>
+struct CFFTKernels
+{
+	//   Instruction set name
+	const char *Name;
+	//   First radix-2 pass with unit transform factors
+	//     Data - N complex entries
+	void (*First2)(T *const Data, const unsigned int N);
+	//   First radix-4 pass with unit transform factors
+	void (*First4)(T *const Data, const unsigned int N, const bool Inverse);
+	//   Radix-4 pass joining transforms of length Step, Step > 1
+	//     Factor - w^g, w^2g and w^3g tables of this pass
+	void (*Pass4)(T *const Data, const unsigned int N, const unsigned int Step,
+		const T *const Factor, const bool Inverse);
+	//   Passes of transform of Count adjacent columns, rows Stride entries apart
+	//   are joined instead of entries, so transform factors are shared by whole rows
+	//     Data   - N rows, first Count entries of every row are transformed
+	//     Factor - w^g, w^2g and w^3g tables of pass of Step, Step may be 1
+	void (*Columns2)(T *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count);
+	void (*Columns4)(T *const Data, const unsigned int N, const unsigned int Stride, const unsigned int Count,
+		const unsigned int Step, const T *const Factor, const bool Inverse);
+};
+
+//   Kernels of every instruction set, 0 if not compiled for this platform
+template <typename T> const CFFTKernels<T> *FFTKernelsSSE2();
+template <typename T> const CFFTKernels<T> *FFTKernelsAVX2();
+template <typename T> const CFFTKernels<T> *FFTKernelsAVX512();
+
+template <> const CFFTKernels<double> *FFTKernelsSSE2<double>();
+template <> const CFFTKernels<float> *FFTKernelsSSE2<float>();
+template <> const CFFTKernels<double> *FFTKernelsAVX2<double>();
+template <> const CFFTKernels<float> *FFTKernelsAVX2<float>();
+template <> const CFFTKernels<double> *FFTKernelsAVX512<double>();
+template <> const CFFTKernels<float> *FFTKernelsAVX512<float>();
+
+//   Best kernels supported by the processor, 0 if none
+template <typename T> const CFFTKernels<T> *FFTKernels();
+
+#endif
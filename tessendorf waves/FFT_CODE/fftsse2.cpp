@@ -0,0 +1,129 @@
+//   fftsse2.cpp - FFT kernels for SSE2 instruction set,
+//   one double or two float complex entries per register
+
+#include "fftsimd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+#include "fftkernel.h"
+
+namespace
+{
+	//   One double complex entry
+	struct D1
+	{
+		typedef double T;
+		typedef __m128d R;
+		static const unsigned int Width = 1;
+
+		static R Load(const T *const Data) { return _mm_loadu_pd(Data); }
+		static void Store(T *const Data, const R Value) { _mm_storeu_pd(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_pd(Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_pd(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_pd(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_pd(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_shuffle_pd(A, A, 1); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			const R Re = _mm_mul_pd(A, _mm_unpacklo_pd(B, B));
+			const R Im = _mm_mul_pd(Swap(A), _mm_unpackhi_pd(B, B));
+			return _mm_add_pd(Re, _mm_xor_pd(Im, _mm_setr_pd(-0., 0.)));
+		}
+	};
+
+	//   One float complex entry in lower half of register
+	struct F1
+	{
+		typedef float T;
+		typedef __m128 R;
+		static const unsigned int Width = 1;
+
+		static R Load(const T *const Data) { return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(Data)); }
+		static void Store(T *const Data, const R Value) { _mm_storel_pi(reinterpret_cast<__m64*>(Data), Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_ps(Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_ps(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_ps(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 3, 0, 1)); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			const R Re = _mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(2, 2, 0, 0)));
+			const R Im = _mm_mul_ps(Swap(A), _mm_shuffle_ps(B, B, _MM_SHUFFLE(3, 3, 1, 1)));
+			return _mm_add_ps(Re, _mm_xor_ps(Im, _mm_setr_ps(-0.f, 0.f, -0.f, 0.f)));
+		}
+	};
+
+	//   Two float complex entries
+	struct F2
+	{
+		typedef float T;
+		typedef __m128 R;
+		static const unsigned int Width = 2;
+
+		static R Load(const T *const Data) { return _mm_loadu_ps(Data); }
+		static void Store(T *const Data, const R Value) { _mm_storeu_ps(Data, Value); }
+		static R Set(const T Re, const T Im) { return _mm_setr_ps(Re, Im, Re, Im); }
+		static R Add(const R A, const R B) { return _mm_add_ps(A, B); }
+		static R Sub(const R A, const R B) { return _mm_sub_ps(A, B); }
+		static R Xor(const R A, const R B) { return _mm_xor_ps(A, B); }
+		//   Exchange of real and imaginary parts
+		static R Swap(const R A) { return _mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 3, 0, 1)); }
+		//   Complex multiplication
+		static R Mul(const R A, const R B)
+		{
+			const R Re = _mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(2, 2, 0, 0)));
+			const R Im = _mm_mul_ps(Swap(A), _mm_shuffle_ps(B, B, _MM_SHUFFLE(3, 3, 1, 1)));
+			return _mm_add_ps(Re, _mm_xor_ps(Im, _mm_setr_ps(-0.f, 0.f, -0.f, 0.f)));
+		}
+	};
+
+	void Pass4(double *const Data, const unsigned int N, const unsigned int Step,
+		const double *const Factor, const bool Inverse)
+	{
+		KernelPass4<D1>(Data, N, Step, Factor, Inverse);
+	}
+
+	void Pass4(float *const Data, const unsigned int N, const unsigned int Step,
+		const float *const Factor, const bool Inverse)
+	{
+		KernelPass4<F2>(Data, N, Step, Factor, Inverse);
+	}
+
+	const CFFTKernels<double> Kernels = { "SSE2", KernelFirst2<D1>, KernelFirst4<D1>, Pass4,
+		KernelColumns2<D1, D1>, KernelColumns4<D1, D1> };
+	const CFFTKernels<float> FloatKernels = { "SSE2", KernelFirst2<F1>, KernelFirst4<F1>, Pass4,
+		KernelColumns2<F2, F1>, KernelColumns4<F2, F1> };
+}
+
+template <>
+const CFFTKernels<double> *FFTKernelsSSE2<double>()
+{
+	return &Kernels;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsSSE2<float>()
+{
+	return &FloatKernels;
+}
+
+#else
+
+template <>
+const CFFTKernels<double> *FFTKernelsSSE2<double>()
+{
+	return 0;
+}
+
+template <>
+const CFFTKernels<float> *FFTKernelsSSE2<float>()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,293 @@
+//headless benchmark of Ocean, no window and no GL, so it runs on any machine
+//every configuration of the sweep is built and run for number of frames,
+//every stage is timed separately and reported as percentiles in JSON or CSV
+//
+//usage: benchmark [options]
+//  --sizes 64,128,256    samples nx = ny of every ocean
+//  --winds 50            wind speeds
+//  --amplitudes 2e-9     values of A
+//  --frames 200          timed frames of every configuration
+//  --warmup 10           frames before timing
+//  --constructions 3     timed constructions of every configuration
+//  --threads n           threads computing ocean, hardware concurrency by default
+//  --choppy lambda       scale of choppy displacement, 0 (default) turns it off
+//  --slopes              calculate slopes with FFT, normals are taken from them
+//  --double              double precision simulation instead of float
+//  --format json|csv     output format, json by default
+//  --output file         write results to file instead of standard output
+//  --trace file          save timeline of all threads in Chrome trace format
+//  --cascades 2000,250   sizes of cascades, frame of maps of all of them is timed too, float only
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cascades.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+	std::vector<double> sizes, winds, amplitudes, cascades;
+	int frames, warmup, constructions, threads;
+	double choppy;
+	bool slopes, isDouble, isCsv;
+	const char *output;
+	const char *trace;
+};
+
+struct Stage {
+	const char *name;
+	std::vector<double> samples; //seconds
+	int grids; //of nx x ny cells calculated by every sample
+};
+
+struct Result {
+	int nx, ny;
+	double wind_speed, A;
+	std::vector<Stage> stages;
+};
+
+static std::vector<double> parseList(const char *text) {
+	std::vector<double> values;
+	for (const char *p = text; *p; ) {
+		char *end;
+		values.push_back(strtod(p, &end));
+		if (end == p) break;
+		p = *end == ',' ? end + 1 : end;
+	}
+	return values;
+}
+
+static double seconds(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double percentile(const std::vector<double> &sorted, double p) {
+
+	//nearest rank, sorted is not empty
+
+	size_t rank = size_t(p / 100 * sorted.size() + 0.5);
+	return sorted[std::min(rank > 0 ? rank - 1 : 0, sorted.size() - 1)];
+}
+
+template <typename T>
+static Result run(const Options &options, int n, double wind_speed, double A) {
+
+	//same lx, ly and min wave size as application
+
+	const double lx = 2000, ly = 2000, dt = 0.006;
+
+	Result result = { n, n, wind_speed, A, {
+		{ "construction", {}, 1 }, { "compute_h", {}, 1 }, { "columns", {}, 1 }, { "rows", {}, 1 }, { "compute_H", {}, 1 },
+		{ "copy", {}, 1 }, { "setMeshHeight", {}, 1 }, { "setMeshNorm", {}, 1 }, { "cascades", {}, 1 } } };
+
+	for (int i = 0; i < options.constructions; i++) {
+		Clock::time_point start = Clock::now();
+		Ocean<T> ocean(lx, ly, n, n, wind_speed, 0.1, A, options.threads);
+		result.stages[0].samples.push_back(seconds(start));
+	}
+
+	Ocean<T> ocean(lx, ly, n, n, wind_speed, 0.1, A, options.threads);
+	ocean.setChoppy(options.choppy);
+	ocean.setSlopes(options.slopes);
+
+	int size;
+	float *mesh = ocean.generateMesh(&size);
+	float *norm = ocean.generateNorm(mesh);
+
+	for (int f = -options.warmup; f < options.frames; f++) {
+		Clock::time_point start = Clock::now();
+		ocean.setMeshHeight(mesh, (f + options.warmup) * dt);
+		double height = seconds(start);
+
+		start = Clock::now();
+		ocean.setMeshNorm(norm, mesh);
+		double normals = seconds(start);
+
+		if (f < 0) continue;
+
+		const typename Ocean<T>::Timings &timings = ocean.lastTimings();
+		result.stages[1].samples.push_back(timings.h);
+		result.stages[2].samples.push_back(timings.columns);
+		result.stages[3].samples.push_back(timings.rows);
+		result.stages[4].samples.push_back(timings.columns + timings.rows);
+		result.stages[5].samples.push_back(timings.copy);
+		result.stages[6].samples.push_back(height);
+		result.stages[7].samples.push_back(normals);
+	}
+
+	delete[] mesh;
+	delete[] norm;
+
+	//height and slope maps of all cascades, as simulation of application calculates them every frame
+	if (!options.cascades.empty() && !options.isDouble) {
+		Cascades cascades(options.cascades, n, n, wind_speed, 0.1, A, options.threads);
+		cascades.setChoppy(options.choppy);
+		cascades.setTimeStep(0, dt);
+
+		std::vector<float> frame(cascades.frameSize());
+		for (int f = -options.warmup; f < options.frames; f++) {
+			Clock::time_point start = Clock::now();
+			cascades.step(frame.data(), nullptr);
+			if (f >= 0) result.stages[8].samples.push_back(seconds(start));
+		}
+		result.stages[8].grids = cascades.count();
+	}
+
+	return result;
+}
+
+static void write(FILE *file, const Options &options, std::vector<Result> &results) {
+
+	//times are in microseconds, ns_per_cell is mean time divided by nx*ny cells of every grid calculated by stage
+
+	if (options.isCsv) {
+		fprintf(file, "nx,ny,wind_speed,A,threads,precision,stage,samples,mean_us,min_us,p50_us,p90_us,p99_us,max_us,ns_per_cell\n");
+	}
+	else {
+		fprintf(file, "{\n  \"threads\": %d,\n  \"precision\": \"%s\",\n  \"frames\": %d,\n  \"choppy\": %g,\n  \"slopes\": %s,\n  \"results\": [",
+			options.threads, options.isDouble ? "double" : "float", options.frames, options.choppy, options.slopes ? "true" : "false");
+	}
+
+	for (size_t r = 0; r < results.size(); r++) {
+		Result &result = results[r];
+
+		if (!options.isCsv) {
+			fprintf(file, "%s\n    {\"nx\": %d, \"ny\": %d, \"wind_speed\": %g, \"A\": %g, \"stages\": {",
+				r ? "," : "", result.nx, result.ny, result.wind_speed, result.A);
+		}
+
+		bool first = true; //stages without samples are skipped, so separator depends on stages already printed
+		for (size_t s = 0; s < result.stages.size(); s++) {
+			std::vector<double> &samples = result.stages[s].samples;
+			if (samples.empty()) continue;
+			std::sort(samples.begin(), samples.end());
+
+			double mean = 0;
+			for (size_t i = 0; i < samples.size(); i++) mean += samples[i];
+			mean /= samples.size();
+
+			double us = 1e6, cells = double(result.nx) * result.ny * result.stages[s].grids;
+
+			if (options.isCsv) {
+				fprintf(file, "%d,%d,%g,%g,%d,%s,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+					result.nx, result.ny, result.wind_speed, result.A, options.threads, options.isDouble ? "double" : "float",
+					result.stages[s].name, int(samples.size()), mean*us, samples.front()*us, percentile(samples, 50)*us,
+					percentile(samples, 90)*us, percentile(samples, 99)*us, samples.back()*us, mean*1e9 / cells);
+			}
+			else {
+				fprintf(file, "%s\n      \"%s\": {\"samples\": %d, \"mean_us\": %.3f, \"min_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"ns_per_cell\": %.3f}",
+					first ? "" : ",", result.stages[s].name, int(samples.size()), mean*us, samples.front()*us, percentile(samples, 50)*us,
+					percentile(samples, 90)*us, percentile(samples, 99)*us, samples.back()*us, mean*1e9 / cells);
+			}
+			first = false;
+		}
+
+		if (!options.isCsv) fprintf(file, "\n    }}");
+	}
+
+	if (!options.isCsv) fprintf(file, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+
+	Options options;
+	options.sizes = { 64, 128, 256 };
+	options.winds = { 50 };
+	options.amplitudes = { 0.000000002 };
+	options.frames = 200;
+	options.warmup = 10;
+	options.constructions = 3;
+	options.threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	options.choppy = 0;
+	options.slopes = false;
+	options.isDouble = false;
+	options.isCsv = false;
+	options.output = nullptr;
+	options.trace = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (arg == "--slopes") options.slopes = true;
+		else if (arg == "--double") options.isDouble = true;
+		else if (!value) {
+			fprintf(stderr, "unknown option or missing value: %s\n", argv[i]);
+			return 1;
+		}
+		else {
+			if (arg == "--sizes") options.sizes = parseList(value);
+			else if (arg == "--winds") options.winds = parseList(value);
+			else if (arg == "--amplitudes") options.amplitudes = parseList(value);
+			else if (arg == "--frames") options.frames = atoi(value);
+			else if (arg == "--warmup") options.warmup = atoi(value);
+			else if (arg == "--constructions") options.constructions = atoi(value);
+			else if (arg == "--threads") options.threads = atoi(value);
+			else if (arg == "--choppy") options.choppy = atof(value);
+			else if (arg == "--format") {
+				if (strcmp(value, "csv") && strcmp(value, "json")) {
+					fprintf(stderr, "unknown format: %s\n", value);
+					return 1;
+				}
+				options.isCsv = strcmp(value, "csv") == 0;
+			}
+			else if (arg == "--output") options.output = value;
+			else if (arg == "--trace") options.trace = value;
+			else if (arg == "--cascades") options.cascades = parseList(value);
+			else {
+				fprintf(stderr, "unknown option: %s\n", argv[i]);
+				return 1;
+			}
+			i++;
+		}
+	}
+
+	//sizes must be powers of 2 for FFT
+	for (size_t i = 0; i < options.sizes.size(); i++) {
+		int n = int(options.sizes[i]);
+		if (n < 2 || (n & (n - 1))) {
+			fprintf(stderr, "size must be power of 2: %g\n", options.sizes[i]);
+			return 1;
+		}
+	}
+
+	if (options.trace) {
+		Trace::setThreadName("benchmark");
+		Trace::enable(true);
+	}
+
+	std::vector<Result> results;
+	for (size_t i = 0; i < options.sizes.size(); i++) {
+		for (size_t w = 0; w < options.winds.size(); w++) {
+			for (size_t a = 0; a < options.amplitudes.size(); a++) {
+				int n = int(options.sizes[i]);
+				fprintf(stderr, "nx = ny = %d, wind speed %g, A %g\n", n, options.winds[w], options.amplitudes[a]);
+
+				if (options.isDouble) results.push_back(run<double>(options, n, options.winds[w], options.amplitudes[a]));
+				else results.push_back(run<float>(options, n, options.winds[w], options.amplitudes[a]));
+			}
+		}
+	}
+
+	FILE *file = options.output ? fopen(options.output, "w") : stdout;
+	if (!file) {
+		fprintf(stderr, "cannot open %s\n", options.output);
+		return 1;
+	}
+
+	write(file, options, results);
+
+	if (options.output) fclose(file);
+
+	if (options.trace && !Trace::write(options.trace)) {
+		fprintf(stderr, "cannot open %s\n", options.trace);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "cascades.h"
+
+#include <string.h>
+
+Cascades::Cascades(const std::vector<double> &sizes, int nx, int ny, double wind_speed, double min_wave_size, double A, int threads) :
+	pool(threads), sizes(sizes), texels(nx * ny), staggered(false), time(0), dt(0), steps(0), timings() {
+
+	//spectrum of Ocean has one wave for every k, waves of smaller patch are sparser in k, so each of them gets more energy,
+	//A grows with square of ratio of sizes, that is with area of k taken by every wave
+
+	//bands meet at a few periods over size of smaller cascade, but not above the highest frequency of larger one
+	std::vector<double> bands(sizes.size() + 1, 0.0);
+	for (size_t c = 1; c < sizes.size(); c++) {
+		bands[c] = std::min(periods * 2 * M_PI / sizes[c], M_PI * std::min(nx, ny) / sizes[c - 1]);
+	}
+
+	for (size_t c = 0; c < sizes.size(); c++) {
+		double scale = sizes[0] / sizes[c];
+		oceans.push_back(new Ocean<float>(sizes[c], sizes[c], nx, ny, wind_speed, min_wave_size, A * scale * scale, &pool));
+		oceans[c]->setSlopes(true);
+		if (sizes.size() > 1) oceans[c]->setBand(bands[c], bands[c + 1]);
+	}
+}
+
+void Cascades::setTimeStep(double t, double dt) {
+
+	time = t;
+	this->dt = dt;
+	steps = 0;
+
+	//staggered cascade c is calculated in steps c, c + count, ..., every time it moves by count steps,
+	//so it starts earlier to be at time of step when it is calculated
+	int n = count();
+	for (int c = 0; c < n; c++) {
+		if (staggered) oceans[c]->setTimeStep(t + (c + 1 - n) * dt, n * dt);
+		else oceans[c]->setTimeStep(t, dt);
+	}
+}
+
+void Cascades::setChoppy(double lambda) {
+	for (size_t c = 0; c < oceans.size(); c++) oceans[c]->setChoppy(lambda);
+}
+
+void Cascades::setStaggered(bool enable) {
+	staggered = enable; //time steps of cascades change, so it takes effect with next setTimeStep
+}
+
+void Cascades::step(float *frame, const float *previous) {
+
+	const int n = count();
+	const int heightSize = stride() * texels;
+
+	time += dt;
+	timings = Timings();
+
+	for (int c = 0; c < n; c++) {
+		float *heights = frame + c * heightSize;
+		float *slopes = frame + n * heightSize + c * 2 * texels;
+
+		if (!staggered || steps % n == c) {
+			oceans[c]->stepHeightMap(heights);
+		}
+		else if (previous) {
+			memcpy(heights, previous + c * heightSize, sizeof(float) * heightSize);
+			memcpy(slopes, previous + n * heightSize + c * 2 * texels, sizeof(float) * 2 * texels);
+			continue;
+		}
+		else {
+			//first frame has no previous one, cascade is calculated at current time without moving its steps
+			oceans[c]->setHeightMap(heights, time);
+		}
+
+		const Ocean<float>::Timings &ocean = oceans[c]->lastTimings();
+		timings.ocean.h += ocean.h;
+		timings.ocean.columns += ocean.columns;
+		timings.ocean.rows += ocean.rows;
+		timings.ocean.copy += ocean.copy;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		oceans[c]->setSlopeMap(slopes);
+		timings.slopes += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	steps++;
+}
+
+double Cascades::maxHeight() const {
+	double height = 0;
+	for (size_t c = 0; c < oceans.size(); c++) height += oceans[c]->maxHeight();
+	return height;
+}
+
+double Cascades::maxDisplacement() const {
+	double displacement = 0;
+	for (size_t c = 0; c < oceans.size(); c++) displacement += oceans[c]->maxDisplacement();
+	return displacement;
+}
+
+Cascades::~Cascades() {
+	for (size_t c = 0; c < oceans.size(); c++) delete oceans[c];
+}
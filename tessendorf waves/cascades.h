@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "ocean.h"
+
+//several Ocean patches of different sizes summed where surface is sampled, so swell and ripples are both covered
+//by grids of modest size instead of one huge grid, every cascade keeps only waves from a few periods over its own size
+//to a few periods over size of next cascade, so no wave is counted twice and long waves do not repeat with small patches
+class Cascades {
+public:
+
+	//sizes - real width and length of every square cascade, from the largest, A - wave height regulation of the largest one,
+	//every cascade has nx x ny samples and slopes, A of smaller ones is scaled, so spectrum has the same density in all of them
+	Cascades(const std::vector<double> &sizes, int nx, int ny, double wind_speed, double min_wave_size, double A, int threads = 1);
+	~Cascades();
+
+	int count() const { return (int)oceans.size(); }
+	double size(int cascade) const { return sizes[cascade]; }
+
+	void setTimeStep(double t, double dt); //start fixed steps of all cascades from time t, can be called again to change t or dt
+	void setChoppy(double lambda); //of all cascades, turning on/off changes stride
+	//staggered step calculates only one cascade in turn, which moves by count time steps at once,
+	//so step costs one cascade and the others are copied from previous frame
+	void setStaggered(bool enable);
+
+	int stride() const { return oceans[0]->meshStride(); } //floats for every texel of height map of one cascade
+	int frameSize() const { return (stride() + 2) * texels * count(); } //floats of frame, height maps of all cascades followed by their slope maps
+
+	//move time by dt and write height and slope maps of all cascades to frame, setTimeStep must be called first
+	//previous - last frame written, staggered step copies cascades it does not calculate from it, null calculates all
+	void step(float *frame, const float *previous);
+
+	double maxHeight() const; //bounds of sum of cascades for any time
+	double maxDisplacement() const;
+
+	//duration in seconds of stages summed over cascades calculated by last step
+	struct Timings {
+		Ocean<float>::Timings ocean; //stages of stepHeightMap or setHeightMap
+		double slopes; //setSlopeMap
+	};
+	const Timings& lastTimings() const { return timings; }
+
+private:
+
+	static const int periods = 4; //of the longest wave of cascade over its size
+
+	ThreadPool pool; //shared by all cascades, they are calculated one after another
+	std::vector<Ocean<float>*> oceans;
+	std::vector<double> sizes;
+	const int texels;
+
+	bool staggered;
+	double time, dt; //of last step
+	int steps; //since setTimeStep, staggered step calculates cascade steps % count
+
+	Timings timings;
+};
@@ -0,0 +1,162 @@
+#include "clipmap.h"
+
+#include <cmath>
+
+Clipmap::Clipmap(int size) : half(size < 4 ? 4 : (size + 3) / 4 * 4), vbo(0), ebo(0), tested(0) {
+
+	int width = 2 * half + 1; //vertices in row
+
+	std::vector<float> grid;
+	grid.reserve(2 * width * width);
+	for (int z = 0; z < width; z++) {
+		for (int x = 0; x < width; x++) {
+			grid.push_back(float(x - half));
+			grid.push_back(float(z - half));
+		}
+	}
+
+	//hole of ring is half of its width, previous level is snapped to its own cells which are half of ring cells,
+	//so hole starts at half/2 or one cell later in x and z, blocks around it are one cell wider or narrower
+	std::vector<GLuint> indices;
+	for (int shape = full; shape < shapes; shape++) {
+		int shiftX = shape == full ? 0 : (shape - hole00) % 2;
+		int shiftZ = shape == full ? 0 : (shape - hole00) / 2;
+		int splitX[] = { 0, half / 2 + shiftX, half + shiftX, 3 * half / 2 + shiftX, 2 * half };
+		int splitZ[] = { 0, half / 2 + shiftZ, half + shiftZ, 3 * half / 2 + shiftZ, 2 * half };
+
+		for (int bz = 0; bz < 4; bz++) {
+			for (int bx = 0; bx < 4; bx++) {
+				//4 center blocks are hole of ring
+				if (shape != full && bx > 0 && bx < 3 && bz > 0 && bz < 3) continue;
+
+				Block block = { splitX[bx], splitZ[bz], splitX[bx + 1], splitZ[bz + 1], (GLsizei)indices.size(), 0 };
+				for (int z = block.z0; z < block.z1; z++) {
+					for (int x = block.x0; x < block.x1; x++) {
+						GLuint corner = z * width + x;
+						GLuint triangles[] = { corner, corner + width, corner + 1, corner + 1, corner + width, corner + width + 1 };
+						indices.insert(indices.end(), triangles, triangles + 6);
+					}
+				}
+				block.count = (GLsizei)indices.size() - block.first;
+				blocks[shape].push_back(block);
+			}
+		}
+	}
+
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * grid.size(), grid.data(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &ebo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+}
+
+void Clipmap::update(double cameraX, double cameraZ, double cell, double range) {
+
+	placed.clear();
+	tested = 0;
+
+	//camera is at most 2 cells from center of level, so level covers at least half - 2 of its cells around it
+	do {
+		Level level;
+		level.cell = cell * (1 << placed.size());
+		level.originX = std::floor(cameraX / (2 * level.cell)) * 2 * level.cell;
+		level.originZ = std::floor(cameraZ / (2 * level.cell)) * 2 * level.cell;
+		level.shape = full;
+
+		//previous level is at the same position or one cell of this level further in x and z
+		if (!placed.empty()) {
+			int dx = (int)std::lround((placed.back().originX - level.originX) / level.cell);
+			int dz = (int)std::lround((placed.back().originZ - level.originZ) / level.cell);
+			level.shape = Shape(hole00 + dx + 2 * dz);
+		}
+		level.visible = (1u << blocks[level.shape].size()) - 1;
+
+		placed.push_back(level);
+	} while ((half - 2) * placed.back().cell < range && (int)placed.size() < maxLevels);
+}
+
+void Clipmap::cull(const glm::mat4 &viewProjection, double height, double displacement) {
+
+	//planes of frustum are sums and differences of rows of matrix, point (x, y, z, 1) is inside
+	//when it is on positive side of all of them, box is outside when its corner furthest along normal of any plane is not
+	double planes[6][4];
+	for (int p = 0; p < 6; p++) {
+		for (int c = 0; c < 4; c++) {
+			planes[p][c] = viewProjection[c][3] + (p % 2 ? -1 : 1) * viewProjection[c][p / 2];
+		}
+	}
+
+	tested = 0;
+	for (size_t i = 0; i < placed.size(); i++) {
+		Level &level = placed[i];
+		const std::vector<Block> &shape = blocks[level.shape];
+		level.visible = 0;
+
+		for (size_t b = 0; b < shape.size(); b++) {
+			//morph moves vertices at most one cell towards lower x and z
+			double low[3] = { level.originX + (shape[b].x0 - half - 1) * level.cell - displacement, -height, level.originZ + (shape[b].z0 - half - 1) * level.cell - displacement };
+			double high[3] = { level.originX + (shape[b].x1 - half) * level.cell + displacement, height, level.originZ + (shape[b].z1 - half) * level.cell + displacement };
+
+			bool inside = true;
+			for (int p = 0; p < 6 && inside; p++) {
+				double distance = planes[p][3];
+				for (int c = 0; c < 3; c++) distance += planes[p][c] * (planes[p][c] > 0 ? high[c] : low[c]);
+				inside = distance >= 0;
+			}
+
+			if (inside) level.visible |= 1u << b;
+			tested++;
+		}
+	}
+}
+
+int Clipmap::blocksDrawn() const {
+	int drawn = 0;
+	for (size_t i = 0; i < placed.size(); i++) {
+		for (unsigned int visible = placed[i].visible; visible; visible &= visible - 1) drawn++;
+	}
+	return drawn;
+}
+
+void Clipmap::draw(GLuint program) const {
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+	GLint originId = glGetUniformLocation(program, "origin");
+	GLint cellId = glGetUniformLocation(program, "cellSize");
+	GLint morphId = glGetUniformLocation(program, "morphRange");
+
+	for (size_t i = 0; i < placed.size(); i++) {
+		const Level &level = placed[i];
+
+		glUniform2f(originId, (float)level.originX, (float)level.originZ);
+		glUniform1f(cellId, (float)level.cell);
+
+		//morph starts at last quarter of level, the last level has no next level and is not morphed
+		float morphWidth = float(half / 4);
+		glUniform2f(morphId, i + 1 < placed.size() ? half - morphWidth : half + 1.0f, morphWidth);
+
+		//visible blocks which are next to each other in index buffer are drawn with one call
+		const std::vector<Block> &shape = blocks[level.shape];
+		for (size_t b = 0; b < shape.size(); b++) {
+			if (!(level.visible & (1u << b))) continue;
+
+			GLsizei first = shape[b].first, count = shape[b].count;
+			while (b + 1 < shape.size() && (level.visible & (1u << (b + 1)))) count += shape[++b].count;
+
+			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * first));
+		}
+	}
+
+	glDisableVertexAttribArray(0);
+}
+
+Clipmap::~Clipmap() {
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ebo);
+}
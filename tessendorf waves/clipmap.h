@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "GL/glew.h"
+#include "glm/mat4x4.hpp"
+
+//camera centered nested grids of ocean surface with density of vertices decreasing with distance,
+//cells of level L are 2^L times larger than cells of level 0, level 0 is full square and every next level is square ring
+//around previous one, so number of vertices grows only with logarithm of view range
+//all levels use one grid of vertices, vertex shader places it with level uniforms and samples height textures at it,
+//near outer edge of level vertices are morphed to positions and mip level of next level, so there are no cracks between levels
+//every level is split into 4 x 4 blocks, 12 without hole of ring, and only blocks in view frustum are drawn
+class Clipmap {
+public:
+
+	Clipmap(int size = 64); //size - half of level width in cells, rounded up to multiple of 4, needs current GL context
+	~Clipmap();
+
+	//place levels around camera, cell - size of cell of level 0, range - distance from camera covered by levels
+	void update(double cameraX, double cameraZ, double cell, double range);
+	//test blocks of placed levels against frustum of viewProjection, which takes x, y, z of surface to clip space,
+	//height and displacement - largest |y| and horizontal move of vertices, every block is visible until it is culled
+	void cull(const glm::mat4 &viewProjection, double height, double displacement);
+	//draw visible blocks with program, grid is vertex attribute 0, vertex shader uniforms are origin, cellSize and morphRange
+	void draw(GLuint program) const;
+
+	int levels() const { return (int)placed.size(); }
+	int size() const { return half; }
+	int blocksTested() const { return tested; } //by last cull
+	int blocksDrawn() const; //visible blocks of placed levels
+
+	static const int maxLevels = 16;
+
+private:
+
+	//level is full square or ring with hole, which is shifted by one cell in x and z when previous level snapped differently
+	enum Shape { full, hole00, hole10, hole01, hole11, shapes };
+
+	struct Level {
+		double originX, originZ; //center of level, multiple of two cells, so every second vertex is vertex of next level
+		double cell;
+		Shape shape;
+		unsigned int visible; //bit for every block of shape
+	};
+
+	struct Block {
+		int x0, z0, x1, z1; //cells of block, from corner of level
+		GLsizei first, count; //range of indices
+	};
+
+	const int half;
+
+	GLuint vbo; //x, z of vertices in cells from center of level
+	GLuint ebo; //triangles of blocks of every shape, blocks of shape are one range after another
+	std::vector<Block> blocks[shapes];
+	int tested;
+
+	std::vector<Level> placed; //levels placed by last update, from the finest
+};
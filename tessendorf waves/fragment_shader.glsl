@@ -1,12 +1,16 @@
 #version 330 core 
 
 in vec3 o_pos;
-in vec3 o_normal;
+in vec2 o_grid;
 
 uniform int isColor;
 uniform samplerCube CubeMap;
 uniform vec3 cameraPosition;
 
+uniform sampler2DArray slopeMap; //dh/dx and dh/dz, layer for every cascade
+uniform vec2 tileSize[3]; //real ocean width and length covered by one repeat of textures of every cascade
+uniform int cascades; //layers of textures
+
 vec3 sunDirection = vec3(0.96, -0.09, 0.45);
 
 vec3 oceanColor = vec3(0, 0.2, 0.3);
@@ -19,7 +23,12 @@ vec3 hdr (vec3 color, float exposure) {
 }
 
 void main (void) {
-    vec3 normal = o_normal;
+    //slopes of all cascades are summed for every pixel, so waves smaller than cells of far levels still shade surface
+    vec2 texels = vec2(textureSize(slopeMap, 0).xy);
+    vec2 slope = vec2(0);
+    for (int c = 0; c < cascades; c++)
+        slope += texture(slopeMap, vec3(o_grid/tileSize[c] + 0.5/texels, c)).rg;
+    vec3 normal = normalize(vec3(-slope.x, 1, -slope.y));
 
 	sunDirection = normalize(sunDirection);
 
@@ -36,7 +45,7 @@ void main (void) {
 
 	float dist = clamp(length( p - dot(p,n)*n )*0.02, 0, 1);
 
-	float sunRate = dot(o_normal, vec3(sunDirection.x, -sunDirection.y, sunDirection.z));
+	float sunRate = dot(normal, vec3(sunDirection.x, -sunDirection.y, sunDirection.z));
 	if(dist < 1 && sunRate > 0.05)
 		sunRate *= 50*(1-dist)*(1-dist);
 	else
@@ -45,7 +54,7 @@ void main (void) {
 
 	vec3 color = sky + water;
 
-	vec3 reflection = reflect(vec3(o_pos.x, -o_pos.yz), o_normal);
+	vec3 reflection = reflect(vec3(o_pos.x, -o_pos.yz), normal);
 
 	if(isColor == 1)
 		gl_FragColor = vec4(0, 0.5, 1, 1);
@@ -1,8 +1,13 @@
 #include <stdio.h>
+#include <string.h>
 #include <time.h> 
 #include <cmath>
 
-#include "ocean.h"
+#include "cascades.h"
+#include "clipmap.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "streamBuffer.h"
 
 #include "GL/glew.h"
 #include "GL/freeglut.h"
@@ -24,20 +29,25 @@ int screen_width = 1280;
 int screen_height = 720;
 
 int fpsMax = 100;
+double timeScale = 0.6; //ocean seconds in every real second
+double timeStep = timeScale / fpsMax; //fixed step of simulation, ocean time follows real time however fast frames are
+double oceanTime = 0; //current ocean time
 int frames; //help count fps
 
-//tile size
+//size of the largest cascade, every next one is cascadeRatio times smaller
 int lx = 2000;
-int ly = 2000;
+int cascadeRatio = 8;
+const int maxCascades = 3; //cascades with cascades on, size of tileSize array in shaders
 
-//tile samples (must be power of 2)
+//samples of every cascade (must be power of 2)
 int nx = 256;
 int ny = 256;
 
 double wind_speed = 50;
 double A = 0.000000002; //value regulating wave height
+double choppy = 1.0; //horizontal displacement of choppy waves
 
-int tiles = 1; //number of tiles in x and y direction
+int threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1; //threads computing ocean every frame
 
 //initial player, camera position and player speed
 double camRotX = 115, camRotY = 0;
@@ -51,18 +61,31 @@ float cameraFar = 1000.0f;
 int wrapX = screen_width / 2;
 int wrapY = screen_height / 2;
 
-Ocean *ocean; //Ocean object generate mesh and normals for Tessendorf Waves
-float *oceanMesh; //current ocean mesh, new ocean mesh is generated when we change one of parameters e.g. wind speed
-float *oceanNorm; //normals of the mesh to calculate reflections
-int nOceanMesh; //used to remember number of mesh vertices
+Cascades *ocean = nullptr; //Ocean patches of different sizes generating heights and slopes for Tessendorf Waves, single precision is enough for float textures
+Simulation *simulation = nullptr; //thread computing next frames of ocean while current one is rendered
+StreamBuffer *oceanStream; //ring of regions frames of heights, displacement and slopes are copied to, textures are updated from it
+int nOceanTex = 0; //number of texels textures are allocated for
+int oceanTexStride = 0; //floats for every texel of height texture, changes with choppy waves
+int oceanTexLayers = 0; //cascades textures are allocated for, one layer of texture array for every cascade
+Clipmap *clipmap; //levels of ocean surface around camera, sampling height textures
 
 bool isSkybox = true; //skybox enable/disable
 bool isLineMode = false; //show only mesh
 bool isSound = true; //sound on/off
+bool isChoppy = true; //choppy waves on/off
+bool isCascades = true; //several ocean patches or one on/off
+bool isStaggered = false; //staggered updates of cascades on/off
+bool isProfiler = false; //profiler overlay on/off
+
+//stages of frame measured by profiler, simulation stages come from simulation thread with every frame it computed
+enum ProfilerStage { stageFrame, stageSkybox, stageSimulation, stageComputeH, stageColumns, stageRows, stageCopy, stageSlopes, stageUpload, stageSurface, stageCount };
+Profiler profiler({ "frame", "skybox", "simulation", "compute_h", "column FFTs", "row FFTs", "copy heights", "slopes", "upload", "surface" });
+char profilerLines[stageCount + 2][80]; //overlay text, header, stages and clipmap, refreshed with fps without allocating
+int nProfilerLines = 0;
 
 GLuint programId; //shader program id
-GLuint vboOcean;
-GLuint vboOceanNorm;
+GLuint texOceanHeight; //heights and displacement sampled by vertex shader, repeated over whole surface
+GLuint texOceanSlopes; //slopes sampled by vertex shader to calculate normals
 
 glm::mat4 M,V,P; //model view perspective for player movement
 //===========================================================
@@ -106,13 +129,32 @@ void resize(int width, int height)
 	glutPostRedisplay();
 }
 //-----------------------------------------------------------
+void createOcean() { //create ocean with current parameters and start its simulation
+	ScopedTrace trace("createOcean");
+
+	//simulation thread uses ocean, so it is stopped first
+	delete simulation;
+	delete ocean;
+
+	std::vector<double> sizes(1, lx);
+	while (isCascades && (int)sizes.size() < maxCascades) sizes.push_back(sizes.back() / cascadeRatio);
+
+	ocean = new Cascades(sizes, nx, ny, wind_speed, 0.1, A, threads);
+	ocean->setChoppy(isChoppy ? choppy : 0);
+	ocean->setStaggered(isStaggered);
+
+	simulation = new Simulation(ocean, oceanTime, timeStep);
+}
+//-----------------------------------------------------------
 void keyboard(GLubyte key, int x, int y)
 {
 	switch (key) {
 
 	case 27: //Esc
+		delete simulation;
 		delete ocean;
-		delete[] oceanMesh;
+		delete oceanStream;
+		delete clipmap;
 
 		exit(1);
 		break;
@@ -156,40 +198,72 @@ void keyboard(GLubyte key, int x, int y)
 	case '4':
 		if (wind_speed > 10) {
 			wind_speed -= 10;
-			delete ocean;
-			delete[] oceanMesh;
-			ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-			oceanMesh = ocean->generateMesh(&nOceanMesh);
+			createOcean();
 		}
 		break;
 
 	//increase wind speed and generate new mesh
 	case '5':
 		wind_speed += 10;
-		delete ocean;
-		delete[] oceanMesh;
-		ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-		oceanMesh = ocean->generateMesh(&nOceanMesh);
+		createOcean();
 		break;
 
 	//decrease wave height and generate new mesh
 	case '6':
 		if (A > 0.000000002) {
 			A -= 0.000000001;
-			delete ocean;
-			delete[] oceanMesh;
-			ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-			oceanMesh = ocean->generateMesh(&nOceanMesh);
+			createOcean();
 		}
 		break;
 
 	//increase wave height and generate new mesh
 	case '7':
 		A += 0.000000001;
-		delete ocean;
-		delete[] oceanMesh;
-		ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-		oceanMesh = ocean->generateMesh(&nOceanMesh);
+		createOcean();
+		break;
+
+	//choppy waves on/off
+	case '8':
+		isChoppy = !isChoppy;
+		delete simulation;
+		ocean->setChoppy(isChoppy ? choppy : 0);
+		simulation = new Simulation(ocean, oceanTime, timeStep);
+		break;
+
+	//profiler overlay on/off
+	case 'p':
+		isProfiler = !isProfiler;
+		break;
+
+	//save timings of last frames to file
+	case 'o':
+		if (profiler.writeCsv("profile.csv")) printf("profile saved to profile.csv\n");
+		break;
+
+	//start tracing or stop it and save timeline of all threads
+	case 't':
+		if (!Trace::enabled()) {
+			Trace::enable(true);
+			printf("tracing started\n");
+		}
+		else {
+			Trace::enable(false);
+			if (Trace::write("trace.json")) printf("trace saved to trace.json\n");
+		}
+		break;
+
+	//cascades on/off
+	case 'c':
+		isCascades = !isCascades;
+		createOcean();
+		break;
+
+	//staggered updates of cascades on/off
+	case 'v':
+		isStaggered = !isStaggered;
+		delete simulation;
+		ocean->setStaggered(isStaggered);
+		simulation = new Simulation(ocean, oceanTime, timeStep);
 		break;
 
 	//decrease wave samples (quality), must be power of 2
@@ -197,10 +271,7 @@ void keyboard(GLubyte key, int x, int y)
 		if (nx > 2 && ny > 2) {
 			nx /= 2;
 			ny /= 2;
-			delete ocean;
-			delete[] oceanMesh;
-			ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-			oceanMesh = ocean->generateMesh(&nOceanMesh);
+			createOcean();
 		}
 		break;
 
@@ -208,19 +279,16 @@ void keyboard(GLubyte key, int x, int y)
 	case '0':
 		nx *= 2;
 		ny *= 2;
-		delete ocean;
-		delete[] oceanMesh;
-		ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-		oceanMesh = ocean->generateMesh(&nOceanMesh);
+		createOcean();
 		break;
 
-	//decrease/increase view range
+	//decrease/increase view range, clipmap adds level every time range doubles
 	case '-':
-		cameraFar -= 100;
+		if (cameraFar > 200) cameraFar /= 1.25f;
 		resize(screen_width, screen_height);
 		break;
 	case '=':
-		cameraFar += 100;
+		if (cameraFar < 50000) cameraFar *= 1.25f;
 		resize(screen_width, screen_height);
 		break;
 	}
@@ -299,6 +367,30 @@ void drawSkybox() {
 	glDepthMask(GL_TRUE); //enable z buffer
 }
 //-----------------------------------------------------------
+void drawProfiler() { //draw profiler statistics in top left corner of window
+	glUseProgram(0);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glDisable(GL_DEPTH_TEST);
+	glColor3f(0, 0, 0);
+
+	for (int i = 0; i < nProfilerLines; i++) {
+		glWindowPos2i(10, screen_height - 20 - 15 * i);
+		glutBitmapString(GLUT_BITMAP_8_BY_13, (const unsigned char*)profilerLines[i]);
+	}
+
+	glEnable(GL_DEPTH_TEST);
+}
+//-----------------------------------------------------------
+void recordSimulation() { //simulation stages of frame from front are recorded in frame which takes it
+	const Simulation::Timings &timings = simulation->frontTimings();
+	profiler.record(stageSimulation, timings.total);
+	profiler.record(stageComputeH, timings.ocean.h);
+	profiler.record(stageColumns, timings.ocean.columns);
+	profiler.record(stageRows, timings.ocean.rows);
+	profiler.record(stageCopy, timings.ocean.copy);
+	profiler.record(stageSlopes, timings.slopes);
+}
+//-----------------------------------------------------------
 void draw()
 {
 	glutWarpPointer(wrapX, wrapY); //wrap mouse to window center
@@ -312,8 +404,10 @@ void draw()
 	glUseProgram(0); //use open gl 2.0 default program
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-	if(isSkybox)
+	if (isSkybox) {
+		ScopedTimer timer(&profiler, stageSkybox);
 		drawSkybox();
+	}
 
 	glUseProgram(programId); //use shader program to render tessnedorf waves
 	if (isLineMode) { //set fragment shader to render only mesh lines
@@ -344,55 +438,115 @@ void draw()
 	GLuint cubeMapId = glGetUniformLocation(programId, "CubeMap");
 	glUniform1i(cubeMapId, 0);
 
-	//generate mesh height in particular time and pass it to shader
-	ocean->setMeshHeight(oceanMesh, 0.6*glutGet(GLUT_ELAPSED_TIME)/1000.);
 	int t = glutGet(GLUT_ELAPSED_TIME)/1000 % 60;
-	glBindBuffer(GL_ARRAY_BUFFER, vboOcean);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 3 * nOceanMesh, oceanMesh, GL_DYNAMIC_DRAW);
+	int nOceanMap = nx * ny;
+
+	//ocean time follows real time, simulation steps towards it and catches up when it is too far behind
+	oceanTime = timeScale * glutGet(GLUT_ELAPSED_TIME) / 1000.;
+	simulation->setTarget(oceanTime);
 
-	//generate mesh normals in particular time and pass it to shader
-	float *oceanNorm = ocean->generateNorm(oceanMesh);
-	glBindBuffer(GL_ARRAY_BUFFER, vboOceanNorm);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 3 * nOceanMesh, oceanNorm, GL_DYNAMIC_DRAW);
+	//frames older than ocean time are skipped when newer one is ready
+	while (simulation->ready() > 1 && simulation->frontTime() + timeStep <= oceanTime) {
+		recordSimulation();
+		simulation->pop();
+	}
 
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, vboOcean);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	//take next frame computed by simulation thread and pass it to shader, frame ahead of ocean time waits,
+	//if simulation is late or ahead textures keep previous frame and it is drawn again
+	const float *oceanFrame = simulation->front();
+	if (oceanFrame && simulation->frontTime() <= oceanTime + timeStep / 2) {
+		ScopedTimer timer(&profiler, stageUpload);
+		recordSimulation();
+
+		int oceanStride = simulation->stride();
+		int oceanLayers = ocean->count();
+		GLsizeiptr oceanMapSize = sizeof(float) * oceanStride * nOceanMap * oceanLayers;
+
+		//frame is copied to free region of stream buffer, so simulation can reuse it at once
+		float *oceanMap = (float*)oceanStream->begin(sizeof(float) * simulation->size());
+		memcpy(oceanMap, oceanFrame, sizeof(float) * simulation->size());
+		simulation->pop();
+
+		//textures storage is allocated only when number of texels or cascades changes, every frame only overwrites it
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texOceanSlopes);
+		if (nOceanTex != nOceanMap || oceanTexLayers != oceanLayers) {
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RG32F, nx, ny, oceanLayers, 0, GL_RG, GL_FLOAT, NULL);
+		}
 
-	glEnableVertexAttribArray(1);
-	glBindBuffer(GL_ARRAY_BUFFER, vboOceanNorm);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		//height texture has only heights or heights and x, z displacement of choppy waves
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texOceanHeight);
+		if (nOceanTex != nOceanMap || oceanTexLayers != oceanLayers || oceanTexStride != oceanStride) {
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, oceanStride > 1 ? GL_RGB32F : GL_R32F, nx, ny, oceanLayers, 0, oceanStride > 1 ? GL_RGB : GL_RED, GL_FLOAT, NULL);
+			oceanTexStride = oceanStride;
+		}
+		nOceanTex = nOceanMap;
+		oceanTexLayers = oceanLayers;
+
+		//only heights, displacement and slopes are sent every frame, one texel for every sample whatever number of vertices is drawn,
+		//stream buffer is bound as pixel unpack buffer, so textures are updated from its region by GPU
+		//maps of cascades follow each other in frame, so every texture array is updated with one call
+		GLintptr oceanOffset = oceanStream->end();
+
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, nx, ny, oceanLayers, oceanStride > 1 ? GL_RGB : GL_RED, GL_FLOAT, (void*)oceanOffset);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+		//far clipmap levels sample mip levels, so they are rebuilt from every frame
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texOceanSlopes);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, nx, ny, oceanLayers, GL_RG, GL_FLOAT, (void*)(oceanOffset + oceanMapSize));
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+		//region is written again only after GPU finishes these uploads
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		oceanStream->fence();
+	}
 
-	//get uniform location of mvp
+	//set textures in vertex shader to displace grid and in fragment shader to calculate normals
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texOceanHeight);
+	glUniform1i(glGetUniformLocation(programId, "heightMap"), 1);
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texOceanSlopes);
+	glUniform1i(glGetUniformLocation(programId, "slopeMap"), 2);
+
+	//cascades are summed where surface is sampled, every one repeats with its own size
+	glActiveTexture(GL_TEXTURE0);
+	GLfloat tileSizes[2 * maxCascades];
+	for (int c = 0; c < ocean->count(); c++) {
+		tileSizes[2 * c] = tileSizes[2 * c + 1] = (GLfloat)ocean->size(c);
+	}
+	glUniform2fv(glGetUniformLocation(programId, "tileSize"), ocean->count(), tileSizes);
+	glUniform1i(glGetUniformLocation(programId, "cascades"), ocean->count());
+
+	//get uniform location of mvp and set it once for all levels
 	GLuint mId = glGetUniformLocation(programId, "M");
 	GLuint vId = glGetUniformLocation(programId, "V");
 	GLuint pId = glGetUniformLocation(programId, "P");
-	
-	//calculate every tile position and render it
-	for (int x = 0; x < tiles; x++) {
-		for (int y = 0; y < tiles; y++) {
-			glm::mat4 M2 = glm::translate(M, glm::vec3(x*lx, 0, y*ly));
-			
-			glUniformMatrix4fv(mId, 1, GL_FALSE, &(M2[0][0]));
-			glUniformMatrix4fv(vId, 1, GL_FALSE, &(V[0][0]));
-			glUniformMatrix4fv(pId, 1, GL_FALSE, &(P[0][0]));
-
-			for (int i = 0; i < ny; i++) {
-				int n = nOceanMesh / (ny);
-				glDrawArrays(GL_TRIANGLE_STRIP, i*n, n);
-			}
-			//glDrawArrays(GL_TRIANGLE_STRIP, 0, nOceanMesh);
-		}
-	}
 
-	glDisableVertexAttribArray(0);
-	glDisableVertexAttribArray(1);
+	glUniformMatrix4fv(mId, 1, GL_FALSE, &(M[0][0]));
+	glUniformMatrix4fv(vId, 1, GL_FALSE, &(V[0][0]));
+	glUniformMatrix4fv(pId, 1, GL_FALSE, &(P[0][0]));
+
+	//levels follow camera, the finest one has cell of one texel, so it has full density of ocean samples,
+	//blocks are culled with bounds of waves for any time, so they do not depend on frame of simulation
+	{
+		ScopedTimer timer(&profiler, stageSurface);
+		clipmap->update(-playerX, -playerZ, double(lx) / nx, cameraFar);
+		clipmap->cull(P*V*M, ocean->maxHeight(), ocean->maxDisplacement());
+		clipmap->draw(programId);
+	}
 
-	//wave mesh change only its height so we don't delete it but normals are not needed
-	delete[] oceanNorm;
+	if (isProfiler)
+		drawProfiler();
 
 	glFlush();
-	glutSwapBuffers();
+	{
+		//waits for vsync and GPU, long swap shows that frame is GPU bound
+		ScopedTrace trace("swap buffers");
+		glutSwapBuffers();
+	}
 
 }
 //-----------------------------------------------------------
@@ -404,10 +558,28 @@ void setFps() { //calculate actual fps and reset frames counter
 	glutSetWindowTitle(buf);
 	timebase = t;
 	frames = 0;
+
+	//profiler statistics are calculated only with fps, overlay shows them until next update
+	nProfilerLines = 0;
+	snprintf(profilerLines[nProfilerLines++], sizeof(profilerLines[0]), "%-14s %8s %8s %8s %8s", "stage [ms]", "last", "min", "avg", "p99");
+	for (int i = 0; i < profiler.stages(); i++) {
+		Profiler::Stats stats = profiler.stats(i);
+		if (!stats.samples) continue;
+		char last[16] = "-"; //stage can be missing in last frame, e.g. simulation was late
+		if (stats.last >= 0) sprintf(last, "%.3f", stats.last * 1000);
+		snprintf(profilerLines[nProfilerLines++], sizeof(profilerLines[0]), "%-14s %8s %8.3f %8.3f %8.3f",
+			profiler.name(i).c_str(), last, stats.min * 1000, stats.avg * 1000, stats.p99 * 1000);
+	}
+	snprintf(profilerLines[nProfilerLines++], sizeof(profilerLines[0]), "%d levels, blocks drawn %d of %d tested",
+		clipmap->levels(), clipmap->blocksDrawn(), clipmap->blocksTested());
 }
 //-----------------------------------------------------------
 void fps(int value) { //render frames with specified fpsMax speed
-	draw();
+	{
+		ScopedTimer timer(&profiler, stageFrame);
+		draw();
+	}
+	profiler.endFrame();
 	if(++frames == 10) setFps(); //show actual fps every 10 frames
 	glutTimerFunc(1000 / fpsMax, fps, 0);
 }
@@ -416,6 +588,8 @@ void nothing() {} //glutDisplayFunc need function which I don't use
 //-----------------------------------------------------------
 int main(int argc, char **argv)
 {
+	Trace::setThreadName("render");
+
 	//open gl and window init
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
@@ -449,17 +623,31 @@ int main(int argc, char **argv)
 
 	//create program to render tessendorf waves
 	programId = loadShaders("vertex_shader.glsl", "fragment_shader.glsl");
-	glBindAttribLocation(programId, 0, "pos");
-	glBindAttribLocation(programId, 1, "normal");
+	glBindAttribLocation(programId, 0, "grid");
 	glLinkProgram(programId);
 	
-	//create ocean and generate mesh without its height
-	ocean = new Ocean(lx, ly, nx, ny, wind_speed, 0.1, A);
-	oceanMesh = ocean->generateMesh(&nOceanMesh);
-
-	//ocean mesh and norm VBO
-	glGenBuffers(1, &vboOcean);
-	glGenBuffers(1, &vboOceanNorm);
+	//create ocean and start its simulation
+	createOcean();
+
+	//ocean stream buffer for texture updates, 3 regions so CPU is never waiting for GPU reading previous frames
+	oceanStream = new StreamBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	//ocean surface, vertices do not depend on number of samples, so it is created once
+	clipmap = new Clipmap();
+
+	//ocean heights and slopes texture arrays, layer for every cascade, sampled between texels and mip levels and repeated over whole surface
+	glGenTextures(1, &texOceanHeight);
+	glGenTextures(1, &texOceanSlopes);
+	GLuint oceanTextures[] = { texOceanHeight, texOceanSlopes };
+	glActiveTexture(GL_TEXTURE1);
+	for (GLuint texture : oceanTextures) {
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+	glActiveTexture(GL_TEXTURE0);
 	
 	//load texture for skybox
 	textureBMP("skybox/skybox_top.bmp", 100);
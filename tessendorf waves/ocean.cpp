@@ -1,25 +1,82 @@
 #include "ocean.h"
 
-Ocean::Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A) :
-	lx(lx), ly(ly), nx(nx), ny(ny), wind_speed(wind_speed), min_wave_size(min_wave_size), A(A) {
+#include <new>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+template <typename T>
+Ocean<T>::Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, int threads) :
+	Ocean(lx, ly, nx, ny, wind_speed, min_wave_size, A, nullptr, threads) {
+}
 
-	h0 = new complex*[ny]; //prepare 2D array to storage Phillips spectrum data
-	h = new complex*[ny]; //function h(k,t) data
-	H = new complex*[nx]; //and real height data
+template <typename T>
+Ocean<T>::Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, ThreadPool *pool) :
+	Ocean(lx, ly, nx, ny, wind_speed, min_wave_size, A, pool, pool->size()) {
+}
 
-	for (int i = 0; i < ny; i++) {
-		h0[i] = new complex[nx];
-		h[i] = new complex[nx];
+template <typename T>
+Ocean<T>::Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, ThreadPool *shared, int threads) :
+	lx(lx), ly(ly), nx(nx), ny(ny), wind_speed(wind_speed), min_wave_size(min_wave_size), A(A), amplitude(0), hStride(rowStride<complex>(nx/2 + 1)),
+	planX(nx), planY(ny), ownPool(shared ? nullptr : new ThreadPool(threads)), pool(shared ? *shared : *ownPool), phase(nullptr), rotation(nullptr), steps(0),
+	D(nullptr), S(nullptr), choppy(0), timings() {
+
+	ScopedTrace trace("Ocean construction");
+
+	h0 = allocRows<complex>(ny, nx); //prepare 2D array to storage Phillips spectrum data
+	h = allocRows<complex>(ny, nx/2 + 1); //function h(k,t) data
+	H = allocRows<T>(ny, nx); //and real height data
+	omega = allocRows<double>(ny, nx/2 + 1); //wave frequency for every k of h
+	kInv = allocRows<T>(ny, nx/2 + 1); //and 1/|k|
+
+	phillipsSpectrum(); //calculate Phillips spectrum
+	dispersion(); //calculate wave frequencies
+}
+
+template <typename T>
+template <typename E>
+E** Ocean<T>::allocRows(int rows, int columns) {
+
+	//all rows are one block, so creating Ocean takes a few allocations instead of one per row,
+	//rows are padded to whole cache lines, so every row is aligned for vector loads
+
+	size_t count = size_t(rows) * rowStride<E>(columns);
+	void *block;
+
+#ifdef _WIN32
+	block = _aligned_malloc(count * sizeof(E), cacheLine);
+#else
+	if (posix_memalign(&block, cacheLine, count * sizeof(E)) != 0) block = nullptr;
+#endif
+	if (!block) throw std::bad_alloc();
+
+	E *first = static_cast<E*>(block);
+	for (size_t i = 0; i < count; i++) {
+		new (first + i) E();
 	}
 
-	for (int i = 0; i < nx; i++) {
-		H[i] = new complex[ny];
+	E **data = new E*[rows];
+	for (int i = 0; i < rows; i++) {
+		data[i] = first + i * rowStride<E>(columns);
 	}
 
-	phillipsSpectrum(); //calculate Phillips spectrum
+	return data;
 }
 
-void Ocean::phillipsSpectrum() {
+template <typename T>
+template <typename E>
+void Ocean<T>::freeRows(E **data) {
+#ifdef _WIN32
+	_aligned_free(data[0]);
+#else
+	free(data[0]);
+#endif
+	delete[] data;
+}
+
+template <typename T>
+void Ocean<T>::phillipsSpectrum() {
 
 	//calculate Phillips spectrum for every point nx, ny
 
@@ -34,11 +91,13 @@ void Ocean::phillipsSpectrum() {
 
 	// h0(k) = 1/sqrt(2) * (dist + i*dist) * sqrt(Ph(k))
 
+	// data is kept in FFT order, indices from n/2 store negative k
+
 	for (int i = 0; i < ny; i++) {
 		for (int j = 0; j < nx; j++) {
 
-			double kx = (2 * M_PI*(j-nx/2)) / lx; //factor x of vector k (wave direction)
-			double ky = (2 * M_PI*(i-ny/2)) / ly; //factor y of vector k (wave direction)
+			double kx = (2 * M_PI*(j < nx/2 ? j : j-nx)) / lx; //factor x of vector k (wave direction)
+			double ky = (2 * M_PI*(i < ny/2 ? i : i-ny)) / ly; //factor y of vector k (wave direction)
 			double k_sq = kx*kx + ky*ky; //k^2
 
 			if (k_sq == 0) {
@@ -52,197 +111,492 @@ void Ocean::phillipsSpectrum() {
 				P /= k_sq*k_sq;
 				P /= 2.;
 				P = sqrt(P);
-				h0[i][j] = complex(P * distribution(generator), P*distribution(generator));
+				h0[i][j] = complex(T(P * distribution(generator)), T(P*distribution(generator)));
 			}
+
+			// |h(k,t)| <= |h0(k)| + |h0(-k)|, every h0 is counted for k and -k
+			amplitude += 2 * std::abs(std::complex<double>(h0[i][j].re(), h0[i][j].im()));
 		}
 	}
 }
 
-void Ocean::compute_h(double t) {
+template <typename T>
+void Ocean<T>::dispersion() {
 
-	//calculate h(k,t) function for time t
+	//calculate wave frequency and 1/|k| for every k of h(k,t), it depends only on grid
+	//so compute_h needs only multiplication by time
+
+	double g = 9.81; //gravitational acceleration
+	double L = 0.1; //surface tension
 
 	for (int i = 0; i < ny; i++) {
-		for (int j = 0; j < nx; j++) {
-			double   A; //waves frequency
-			double   L = 0.1; //surface tension
-			double k_sq = pow((2 * M_PI*j) / lx, 2) + pow((2 * M_PI*i) / ly, 2); //k^2, k - wave direction
+		for (int j = 0; j < nx/2 + 1; j++) {
+			double kx = (2 * M_PI*j) / lx;
+			double ky = (2 * M_PI*(i < ny/2 ? i : i-ny)) / ly;
+			double k_sq = kx*kx + ky*ky; //k^2, k - wave direction
 
-			// A = gk(1 + k^2 * L^2) - wave frequency
-			A = t*sqrt(9.81*sqrt(k_sq) * (1 + k_sq*pow(L, 2)));
+			// w = sqrt(gk(1 + k^2 * L^2)) - wave frequency
+			omega[i][j] = sqrt(g*sqrt(k_sq) * (1 + k_sq*L*L));
 
-			// h(k,t) = h0(k) * exp(iAt) + h0*(-k) * exp(-iAt)
-			h[i][j] = h0[i][j] * (cos(A) + complex::i*sin(A)) + h0[ny - i - 1][nx - j - 1] * (cos(-A) + complex::i*sin(-A));
+			// 1/|k| for displacement, 0 for k = 0 and frequencies nx/2 and ny/2
+			kInv[i][j] = (k_sq == 0 || 2*i == ny || 2*j == nx) ? T(0) : T(1 / sqrt(k_sq));
 		}
 	}
 }
 
-void Ocean::compute_H() {
+template <typename T>
+void Ocean<T>::compute_h(double t) {
 
-	//calculate FFT for h(k,t) function
+	//calculate h(k,t) function for time t
+	//only columns with kx >= 0 are needed, the rest is given by h(-k,t) = h*(k,t)
+	//every thread calculates its range of rows
 
-	for (int i = 0; i < ny; i++) {
-		CFFT::Forward(h[i], nx);
+	pool.parallelFor(ny, [this, t](int, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			for (int j = 0; j < nx/2 + 1; j++) {
+				double A = t*omega[i][j]; //wave phase
+
+				// exp(iAt)
+				complex e(T(cos(A)), T(sin(A)));
+
+				// h(k,t) = h0(k) * exp(iAt) + h0*(-k) * exp(-iAt)
+				h[i][j] = h0[i][j] * e + h0[(ny - i) % ny][(nx - j) % nx].conjugate() * e.conjugate();
+			}
+		}
+
+		if (D || S) compute_fields(begin, end);
+	});
+}
+
+template <typename T>
+void Ocean<T>::step_h() {
+
+	//calculate h(k,t) function for next time step
+	//phase exp(iAt) of every wave is multiplied by exp(iA dt), so no cos and sin are needed,
+	//rounding errors change length of phase, so every renormalizeSteps steps it is brought back to 1
+
+	bool renormalize = ++steps % renormalizeSteps == 0;
+
+	pool.parallelFor(ny, [this, renormalize](int, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			complex *e = phase[i];
+			const complex *r = rotation[i];
+
+			for (int j = 0; j < nx/2 + 1; j++) {
+				e[j] *= r[j];
+
+				if (renormalize) {
+					// 1/|e| ~ (3 - |e|^2) / 2, |e| is close to 1
+					e[j] *= (T(3) - e[j].norm()) / T(2);
+				}
+
+				// h(k,t) = h0(k) * exp(iAt) + h0*(-k) * exp(-iAt)
+				h[i][j] = h0[i][j] * e[j] + h0[(ny - i) % ny][(nx - j) % nx].conjugate() * e[j].conjugate();
+			}
+		}
+
+		if (D || S) compute_fields(begin, end);
+	});
+}
+
+template <typename T>
+void Ocean<T>::compute_fields(int begin, int end) {
+
+	//calculate spectra of choppy displacement and slopes from rows of h(k,t) at k and -k
+	//every spectrum packs two real fields as A(k) + iB(k), inverse FFT of it gives a + ib,
+	//A and B are hermitian, so value for -k is A*(k) + iB*(k)
+	//only columns with kx >= 0 of h are calculated, so columns of -k are written here,
+	//columns 0 and nx/2 are their own pairs and are written by row of -k
+	//frequencies nx/2 and ny/2 have no pair with opposite sign, derivatives of them would not be real, so they are 0
+
+	const T dkx = T((2 * M_PI) / lx);
+
+	for (int i = begin; i < end; i++) {
+		const int mi = (ny - i) % ny;
+		const bool nyquist = 2*i == ny;
+		const T kz = nyquist ? T(0) : T((2 * M_PI*(i < ny/2 ? i : i-ny)) / ly);
+		const complex *hRow = h[i];
+		const T *kRow = kInv[i];
+
+		if (D) {
+			complex *d = D[i], *dMirror = D[mi];
+
+			// D(k) = -i * k/|k| * h(k,t), kInv is 0 for frequencies without pair
+			for (int j = 0; j < nx/2; j++) {
+				const T ax = dkx*j*kRow[j], az = kz*kRow[j];
+				const complex a(hRow[j].im() * ax, -hRow[j].re() * ax);
+				const complex b(hRow[j].im() * az, -hRow[j].re() * az);
+				d[j] = complex(a.re() - b.im(), a.im() + b.re());
+				if (j > 0) dMirror[nx - j] = complex(a.re() + b.im(), b.re() - a.im());
+			}
+			d[nx/2] = 0;
+		}
+
+		if (S) {
+			complex *s = S[i], *sMirror = S[mi];
+
+			// S(k) = i * k * h(k,t)
+			for (int j = 0; j < nx/2; j++) {
+				const T ax = nyquist ? T(0) : dkx*j;
+				const complex a(-hRow[j].im() * ax, hRow[j].re() * ax);
+				const complex b(-hRow[j].im() * kz, hRow[j].re() * kz);
+				s[j] = complex(a.re() - b.im(), a.im() + b.re());
+				if (j > 0) sMirror[nx - j] = complex(a.re() + b.im(), b.re() - a.im());
+			}
+			s[nx/2] = 0;
+		}
 	}
+}
+
+template <typename T>
+void Ocean<T>::compute_H() {
+
+	//calculate inverse FFT for h(k,t) function
+	//columns are transformed first, after that every row is hermitian and gives real heights
+	//columns are transformed in blocks of adjacent columns straight in rows of h, so no transpose is needed,
+	//every thread transforms its range of blocks, all columns must be done before rows start
+	//spectra of displacement and slopes are full complex transforms done in the same loops,
+	//so all fields share plans, threads and waiting for them
+
+	const int width = nx/2 + 1;
+	const int blocksH = (width + blockColumns - 1) / blockColumns;
+	const int blocksField = (nx + blockColumns - 1) / blockColumns;
 
-	for (int i = 0; i < nx; i++) {
-		for (int j = 0; j < ny; j++) {
-			H[i][j] = h[j][i];
+	complex **fields[2];
+	int nFields = 0;
+	if (D) fields[nFields++] = D;
+	if (S) fields[nFields++] = S;
+
+	Clock::time_point start = Clock::now();
+
+	pool.parallelFor(blocksH + nFields * blocksField, [&](int, int begin, int end) {
+		for (int b = begin; b < end; b++) {
+			if (b < blocksH) {
+				int first = b * blockColumns;
+				planY.InverseColumns(h[0] + first, hStride, std::min(first + blockColumns, width) - first, false);
+			}
+			else {
+				int first = (b - blocksH) % blocksField * blockColumns;
+				complex **field = fields[(b - blocksH) / blocksField];
+				planY.InverseColumns(field[0] + first, rowStride<complex>(nx), std::min(first + blockColumns, nx) - first, false);
+			}
 		}
-		CFFT::Forward(H[i], ny);
+	});
+
+	Clock::time_point columns = Clock::now();
+
+	pool.parallelFor(ny * (1 + nFields), [&](int, int begin, int end) {
+		for (int r = begin; r < end; r++) {
+			if (r < ny) {
+				planX.InverseReal(h[r], H[r], false);
+			}
+			else {
+				planX.Inverse(fields[(r - ny) / ny][(r - ny) % ny], false);
+			}
+		}
+	});
+
+	Clock::time_point rows = Clock::now();
+	timings.columns = std::chrono::duration<double>(columns - start).count();
+	timings.rows = std::chrono::duration<double>(rows - columns).count();
+
+	if (Trace::enabled()) {
+		Trace::record("column FFTs", Trace::time(start), Trace::time(columns));
+		Trace::record("row FFTs", Trace::time(columns), Trace::time(rows));
 	}
 }
 
-float* Ocean::generateMesh(int *size) {
+template <typename T>
+void Ocean<T>::update(bool step, double t, float *mesh, int columns, int rows) {
 
-	//generate Ocean mesh as ny TRIANGLE_STRIPs
+	//every stage is timed, so it is known where time of frame goes
 
-	float *mesh = new float[3 * 2 * (nx+1) * ny];
+	Clock::time_point start = Clock::now();
+	if (step) step_h();
+	else compute_h(t);
+	Clock::time_point computed = Clock::now();
+	timings.h = std::chrono::duration<double>(computed - start).count();
 
-	for (int i = 0; i < ny; i++) {
-		for (int j = 0; j < nx+1; j++) {
-			int pos = (i*(nx+1) + j) * 6;
+	compute_H();
+
+	Clock::time_point transformed = Clock::now();
+	copyHeight(mesh, columns, rows);
+	Clock::time_point copied = Clock::now();
+	timings.copy = std::chrono::duration<double>(copied - transformed).count();
 
-			mesh[pos] = (lx / nx)*j;
-			mesh[pos + 1] = 0;
-			mesh[pos + 2] = (ly / ny)*i;
+	if (Trace::enabled()) {
+		Trace::record("compute_h", Trace::time(start), Trace::time(computed));
+		Trace::record("copy heights", Trace::time(transformed), Trace::time(copied));
+	}
+}
 
-			mesh[pos + 3] = (lx / nx)*j;
-			mesh[pos + 4] = 0;
-			mesh[pos + 5] = (ly / ny)*(i+1);
+template <typename T>
+void Ocean<T>::setChoppy(double lambda) {
+
+	//displacement spectrum is calculated only if it is used
+
+	choppy = lambda;
+
+	if (choppy != 0 && !D) {
+		D = allocRows<complex>(ny, nx);
+	}
+	else if (choppy == 0 && D) {
+		freeRows(D);
+		D = nullptr;
+	}
+}
+
+template <typename T>
+void Ocean<T>::setBand(double kMin, double kMax) {
+
+	//waves out of band are removed from spectrum, so they cost nothing in bounds but still in FFT
+
+	amplitude = 0;
+
+	for (int i = 0; i < ny; i++) {
+		for (int j = 0; j < nx; j++) {
+			double kx = (2 * M_PI*(j < nx/2 ? j : j-nx)) / lx;
+			double ky = (2 * M_PI*(i < ny/2 ? i : i-ny)) / ly;
+			double k = sqrt(kx*kx + ky*ky);
+
+			if (k < kMin || (kMax > 0 && k >= kMax)) h0[i][j] = 0;
+			amplitude += 2 * std::abs(std::complex<double>(h0[i][j].re(), h0[i][j].im()));
 		}
 	}
+}
 
-	*size = 2 * (nx+1) * ny;
+template <typename T>
+void Ocean<T>::setSlopes(bool enable) {
+	if (enable && !S) {
+		S = allocRows<complex>(ny, nx);
+	}
+	else if (!enable && S) {
+		freeRows(S);
+		S = nullptr;
+	}
+}
+
+template <typename T>
+float* Ocean<T>::generateMesh(int *size) {
+
+	//generate changing part of Ocean mesh for (nx+1)x(ny+1) grid of vertices, meshStride floats for every vertex,
+	//height and if choppy waves are on x and z displacement
+
+	float *mesh = new float[meshStride() * (nx+1) * (ny+1)]();
+
+	*size = (nx+1) * (ny+1);
 	return mesh;
 }
 
-float* Ocean::generateNorm(float* mesh) {
+template <typename T>
+float* Ocean<T>::generateNorm(float* mesh) {
 
 	//generate normal vectors for ocean Mesh
 
-	int size = 2 * (nx+1) * ny;
+	int size = (nx+1) * (ny+1);
 	float* norm = new float[3 * size];
-	int triangles = nx*2;
 
-	for (int i = 0; i < ny; i++) {
-		for (int j = 0; j < triangles; j++) {
+	setMeshNorm(norm, mesh);
+	return norm;
+}
 
-			int pos = ((triangles + 2)*i + j) * 3;
-			//for last strip copy normal vector of first edge of first strip
-			//it allows for continuity if we create more than 1 tile
+template <typename T>
+void Ocean<T>::setMeshNorm(float *norm, float *mesh) {
 
-			if ((i == ny - 1) && (j % 2)) {
-				norm[pos] = norm[(j - 1) * 3];
-				norm[pos + 1] = norm[(j - 1) * 3 + 1];
-				norm[pos + 2] = norm[(j - 1) * 3 + 2];
+	//with slopes calculated by FFT normals come straight from them, no mesh walk is needed
+	if (S) {
+		copyNorm(norm);
+		return;
+	}
 
-				//for two last vertices of strip copy normal vector of two first vertices to keep continuity
+	//normal of every vertex is cross product of vectors between its neighbours in z and x direction,
+	//neighbours behind edges of tile are taken from opposite edge, so tiles are continuous
 
-				if (j == triangles - 1) {
-					int pos2 = pos - (triangles - 1)*3;
-					norm[pos + 3] = norm[pos2];
-					norm[pos + 4] = norm[pos2+1];
-					norm[pos + 5] = norm[pos2+2];
+	pool.parallelFor(ny, [this, norm, mesh](int, int begin, int end) {
+		const int stride = meshStride();
 
-					norm[pos + 6] = norm[pos2+3];
-					norm[pos + 7] = norm[pos2 + 4];
-					norm[pos + 8] = norm[pos2 + 5];
-				}
-				continue;
+		//position of vertex, i and j can be one step outside of tile
+		auto vertex = [this, mesh, stride](int i, int j) {
+			const float *m = mesh + (((i + ny) % ny)*(nx+1) + (j + nx) % nx)*stride;
+			return stride > 1 ? glm::vec3((lx / nx)*j + m[1], m[0], (ly / ny)*i + m[2]) : glm::vec3((lx / nx)*j, m[0], (ly / ny)*i);
+		};
+
+		for (int i = begin; i < end; i++) {
+			for (int j = 0; j < nx; j++) {
+				glm::vec3 ex = vertex(i, j+1) - vertex(i, j-1);
+				glm::vec3 ez = vertex(i+1, j) - vertex(i-1, j);
+				glm::vec3 normal = glm::normalize(glm::cross(ez, ex));
+
+				norm[(i*(nx+1) + j)*3] = normal.x;
+				norm[(i*(nx+1) + j)*3 + 1] = normal.y;
+				norm[(i*(nx+1) + j)*3 + 2] = normal.z;
 			}
-			//if strip is not first, normal vector of first edge is the same as previous strip
-			//we need to copy it
-			if (!(j % 2) && i > 0) {
-				norm[pos] = norm[pos - (triangles + 1) * 3];
-				norm[pos + 1] = norm[pos - (triangles + 1) * 3 + 1];
-				norm[pos + 2] = norm[pos - (triangles + 1) * 3 + 2];
-				continue;
+
+			//vertex of nx edge gets normal of opposite edge
+			for (int k = 0; k < 3; k++) {
+				norm[(i*(nx+1) + nx)*3 + k] = norm[i*(nx+1)*3 + k];
 			}
-			
-			//get xyz coordinates of triangle vertices
-			glm::vec3 v1 = glm::vec3(mesh[pos], mesh[pos + 1], mesh[pos + 2]);
-			glm::vec3 v2 = glm::vec3(mesh[pos + 3], mesh[pos + 4], mesh[pos + 5]);
-			glm::vec3 v3 = glm::vec3(mesh[pos + 6], mesh[pos + 7], mesh[pos + 8]);
+		}
+	});
 
-			//calculate 2 edges of triangle
-			glm::vec3 e1 = v2 - v1;
-			glm::vec3 e2 = v3 - v1;
+	//row of ny edge gets normals of opposite edge
+	std::copy(norm, norm + (nx+1)*3, norm + ny*(nx+1)*3);
+}
 
-			//calculate normal vector from this edges
-			glm::vec3 normal = glm::normalize(glm::cross(e1, e2));
-			//every second triangle has normal vector directed down, we need to revert it
-			if (normal.y < 0) normal = -normal;
+template <typename T>
+void Ocean<T>::setMeshHeight(float *mesh, double t) {
+	update(false, t, mesh, nx+1, ny+1);
+}
 
-			norm[pos] = normal.x;
-			norm[pos + 1] = normal.y;
-			norm[pos + 2] = normal.z;
+template <typename T>
+void Ocean<T>::setTimeStep(double t, double dt) {
 
-			//for two last vertices of strip copy normal vector of two first vertices to keep continuity
-			if (j == triangles - 1) {
-				int pos2 = pos - (triangles - 1) * 3;
-				norm[pos + 3] = norm[pos2];
-				norm[pos + 4] = norm[pos2 + 1];
-				norm[pos + 5] = norm[pos2 + 2];
+	//prepare phase of every wave for time t and its rotation for time step dt
 
-				norm[pos + 6] = norm[pos2 + 3];
-				norm[pos + 7] = norm[pos2 + 4];
-				norm[pos + 8] = norm[pos2 + 5];
-			}
+	if (!phase) {
+		phase = allocRows<complex>(ny, nx/2 + 1);
+		rotation = allocRows<complex>(ny, nx/2 + 1);
+	}
+
+	for (int i = 0; i < ny; i++) {
+		for (int j = 0; j < nx/2 + 1; j++) {
+			phase[i][j] = complex(T(cos(t*omega[i][j])), T(sin(t*omega[i][j])));
+			rotation[i][j] = complex(T(cos(dt*omega[i][j])), T(sin(dt*omega[i][j])));
 		}
 	}
-	return norm;
+
+	steps = 0;
 }
 
-void Ocean::setMeshHeight(float *mesh, double t) {
-	compute_h(t);
-	compute_H();
+template <typename T>
+float* Ocean<T>::generateHeightMap(int *size) {
 
-	for (int i = 0; i < ny; i++) {
-		for (int j = 0; j < nx+1; j++) {
-			int pos = (i*(nx+1) + j) * 6;
+	//height map has the same texel layout as mesh vertices but without copied nx and ny edges,
+	//texture with it is sampled with repeat, so edges come from opposite side anyway
 
-			//if we set height for nx, ny edge or nx,ny vertex
-			//we need to copy height from opposite edge to keep continuity of tiles
+	float *map = new float[meshStride() * nx * ny]();
 
+	*size = nx * ny;
+	return map;
+}
 
-			//because of H calculation every second value is negative, we need to revert it
-			if (j == nx && i == ny - 1)
-			{
-				mesh[pos + 1] = H[0][i].re()*((i + j) % 2 ? 1 : -1);
-				mesh[pos + 4] = H[0][0].re()*((i + j + 1) % 2 ? 1 : -1);
-				continue;
+template <typename T>
+void Ocean<T>::setHeightMap(float *map, double t) {
+	update(false, t, map, nx, ny);
+}
+
+template <typename T>
+void Ocean<T>::stepHeightMap(float *map) {
+	update(true, 0, map, nx, ny);
+}
+
+template <typename T>
+float* Ocean<T>::generateSlopeMap(int *size) {
+	float *map = new float[2 * nx * ny]();
+
+	*size = nx * ny;
+	return map;
+}
+
+template <typename T>
+void Ocean<T>::setSlopeMap(float *map) {
+
+	//slopes are calculated by FFT together with heights, every thread copies its range of rows
+
+	ScopedTrace trace("setSlopeMap");
+
+	pool.parallelFor(ny, [this, map](int, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			float *row = map + i*nx*2;
+
+			for (int j = 0; j < nx; j++) {
+				row[j*2] = float(S[i][j].re());
+				row[j*2 + 1] = float(S[i][j].im());
 			}
+		}
+	});
+}
+
+template <typename T>
+void Ocean<T>::copyHeight(float *mesh, int columns, int rows) {
+
+	//every thread copies its range of mesh rows,
+	//vertices of nx and ny edges get height of opposite edge to keep continuity of tiles
+
+	pool.parallelFor(rows, [this, mesh, columns](int, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			const T *h1 = H[i % ny];
 
-			if (j == nx) {
-				mesh[pos + 1] = H[0][i].re()*((i + j) % 2 ? 1 : -1);
-				mesh[pos + 4] = H[0][i + 1].re()*((i + j + 1) % 2 ? 1 : -1);
+			if (!D) {
+				float *row = mesh + i*columns;
+
+				for (int j = 0; j < nx; j++) {
+					row[j] = float(h1[j]);
+				}
+				if (columns > nx) row[nx] = float(h1[0]);
 				continue;
 			}
 
-			if (i == ny - 1) {
-				mesh[pos + 1] = H[j][i].re()*((i + j) % 2 ? 1 : -1);
-				mesh[pos + 4] = H[j][0].re()*((i + j + 1) % 2 ? 1 : -1);
-				continue;
+			//choppy waves move vertices horizontally, real part of D is x and imaginary part is z
+			const complex *d1 = D[i % ny];
+			float *row = mesh + i*columns*3;
+
+			for (int j = 0; j < columns; j++) {
+				row[j*3] = float(h1[j % nx]);
+				row[j*3 + 1] = float(choppy*d1[j % nx].re());
+				row[j*3 + 2] = float(choppy*d1[j % nx].im());
+			}
+		}
+	});
+}
+
+template <typename T>
+void Ocean<T>::copyNorm(float *norm) {
+
+	//normal of surface y = h(x, z) is (-dh/dx, 1, -dh/dz) normalized,
+	//every vertex gets normal of its own point, so shading is smooth
+	//every thread copies its range of mesh rows
+
+	pool.parallelFor(ny+1, [this, norm](int, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			const complex *s1 = S[i % ny];
+			float *n = norm + i*(nx+1)*3;
+
+			for (int j = 0; j < nx; j++) {
+				const T l = T(1) / std::sqrt(s1[j].norm() + T(1));
+
+				n[j*3] = float(-s1[j].re() * l);
+				n[j*3 + 1] = float(l);
+				n[j*3 + 2] = float(-s1[j].im() * l);
 			}
 
-			mesh[pos + 1] = H[j][i].re()*((i + j) % 2 ? 1 : -1);
-			mesh[pos + 4] = H[j][i + 1].re()*((i + j + 1) % 2 ? 1 : -1);
+			//vertex of nx edge gets normal of opposite edge to keep continuity of tiles
+			for (int k = 0; k < 3; k++) {
+				n[nx*3 + k] = n[k];
+			}
 		}
-	}
+	});
 }
 
-Ocean::~Ocean() {
-	for (int i = 0; i < ny; i++) {
-		delete[] h0[i];
-		delete[] h[i];
+template <typename T>
+Ocean<T>::~Ocean() {
+	freeRows(h0);
+	freeRows(h);
+	freeRows(H);
+	freeRows(omega);
+	freeRows(kInv);
+
+	if (phase) {
+		freeRows(phase);
+		freeRows(rotation);
 	}
 
-	for (int i = 0; i < nx; i++) {
-		delete[] H[i];
-	}
+	if (D) freeRows(D);
+	if (S) freeRows(S);
+
+	delete ownPool;
+}
 
-	delete[] h0;
-	delete[] h;
-	delete[] H;
-}
\ No newline at end of file
+//single and double precision simulation
+template class Ocean<float>;
+template class Ocean<double>;
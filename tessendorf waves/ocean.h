@@ -5,32 +5,93 @@
 #include <random>
 #include <ctime>
 #include <complex>
+#include <algorithm>
+#include <chrono>
 
 #include "glm/vec3.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
-#include "FFT_CODE\complex.h"
-#include "FFT_CODE\fft.h"
+#include "FFT_CODE/complex.h"
+#include "FFT_CODE/fft.h"
 
+#include "threadPool.h"
+#include "trace.h"
+
+//T - precision of simulation, float or double
+template <typename T>
 class Ocean {
 public:
 
-	Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A);
-	float* generateMesh(int *size); //generate Ocean mesh without height, returns number of generated vertices in size var
-	float* generateNorm(float *mesh); //generate normals for Ocean mesh
+	//threads - number of threads computing every frame
+	Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, int threads = 1);
+	//pool - threads shared with other oceans computed one after another, must live longer than Ocean
+	Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, ThreadPool *pool);
+	//mesh of (nx+1) x (ny+1) vertices has only changing heights with displacement, x and z of vertices are not stored
+	float* generateMesh(int *size); //generate changing part of Ocean mesh without height, returns number of vertices in size var
+	int meshStride() const { return D ? 3 : 1; } //floats for every vertex of mesh, height and x, z displacement with choppy waves
+	float* generateNorm(float *mesh); //generate normals for Ocean mesh, from slopes if setSlopes(true), else from neighbouring vertices of mesh
 
 	void setMeshHeight(float *mesh, double t); //set mesh height in particular time
+	void setMeshNorm(float *norm, float *mesh); //set normals from generateNorm for current mesh height, allocates nothing
+
+	//fixed time step mode, phase of every wave is rotated by dt on every step
+	//instead of computing cos and sin for every wave in every frame
+	void setTimeStep(double t, double dt); //start fixed steps from time t, can be called again to change t or dt
+
+	//height field for textures, nx x ny texels laid out like mesh without its copied nx and ny edges,
+	//one texture serves every tile and mesh of any density which samples it with repeat
+	float* generateHeightMap(int *size); //meshStride floats for every texel, returns number of texels in size var
+	void setHeightMap(float *map, double t); //set heights and displacement in particular time
+	void stepHeightMap(float *map); //move time by dt and set heights and displacement, setTimeStep must be called first
+	float* generateSlopeMap(int *size); //dh/dx and dh/dz for every texel, returns number of texels in size var
+	void setSlopeMap(float *map); //set slopes calculated with last heights, setSlopes(true) must be called first
+
+	//additional fields calculated with heights, every pair of real fields costs one complex FFT
+	void setChoppy(double lambda); //scale of horizontal displacement of choppy waves, 0 (default) turns it off, turning on/off changes meshStride
+	void setSlopes(bool enable); //calculate slopes dh/dx and dh/dz of heights and take normals from them, off by default
+	void setBand(double kMin, double kMax); //keep only waves with kMin <= |k| < kMax, kMax 0 for no upper limit, e.g. for cascades
+
+	//bounds for any time, e.g. for culling, sum of amplitudes of all waves, so far above heights really reached
+	double maxHeight() const { return amplitude; } //of |height|
+	double maxDisplacement() const { return choppy < 0 ? -choppy*amplitude : choppy*amplitude; } //of length of x, z displacement
+
+	//duration in seconds of stages of last setMeshHeight, setHeightMap or stepHeightMap
+	struct Timings {
+		double h; //h(k,t) with spectra of displacement and slopes
+		double columns; //inverse FFTs of columns
+		double rows; //inverse FFTs of rows
+		double copy; //copy of heights and displacement to mesh or map
+	};
+	const Timings& lastTimings() const { return timings; }
 	~Ocean();
 
 private:
 
+	typedef tcomplex<T> complex;
+	typedef std::chrono::steady_clock Clock;
+
 	void phillipsSpectrum(); //calculate Phillips spectrum and save it in h0
+	void dispersion(); //calculate wave frequency and 1/|k| for every k and save it in omega and kInv
 	void compute_h(double t); //calculate values of h(k,t) function and save it in h
-	void compute_H(); //calculate wave heights with h(k,t) function and FFT and save it in H
+	void step_h(); //rotate phases by time step and calculate values of h(k,t) function with them
+	void compute_fields(int begin, int end); //calculate spectra of D and S from rows begin to end of h(k,t)
+	void compute_H(); //calculate wave heights with h(k,t) function and inverse FFT and save it in H
+	void update(bool step, double t, float *mesh, int columns, int rows); //compute_h(t) or step_h, compute_H and copyHeight with timings
+	void copyHeight(float *mesh, int columns, int rows); //copy wave heights from H and displacement from D to mesh or map with columns x rows vertices
+	void copyNorm(float *norm); //calculate normals of mesh vertices from slopes S
+
+	template <typename E>
+	static E** allocRows(int rows, int columns); //2D array in one block aligned to cache line, every row starts at cache line
+	template <typename E>
+	static void freeRows(E **data); //release array from allocRows
+	template <typename E>
+	static int rowStride(int columns) { return (columns + cacheLine/sizeof(E) - 1) / (cacheLine/sizeof(E)) * (cacheLine/sizeof(E)); } //row length with padding to whole cache lines
 
 	complex **h0, //Phillps spectrum data
-			**h, //h(k,t) function values data used in FFT
-			**H; //wave heights data
+			**h; //h(k,t) function values data used in FFT, only nx/2+1 columns because h(-k,t) = h*(k,t)
+	T       **H; //wave heights data
+	double  **omega; //wave frequency for every k of h, double keeps phase precise for large t
+	T       **kInv; //1/|k| for every k of h, 0 for k without -k pair
 
 	const double lx; //real ocean width
 	const double ly; //real ocean lenght
@@ -40,4 +101,31 @@ private:
 	const double wind_speed;
 	const double min_wave_size;
 	const double A; //constant to regulate wave height
+	double amplitude; //sum of |h(k,t)| bound for every t, heights and displacement are not larger
+
+	const int hStride; //distance between rows of h, columns of h are transformed in place with it
+
+	static const int cacheLine = 64; //alignment of h0, h and H rows
+
+	static const int blockColumns = 32; //adjacent columns of h transformed together, every row gives a few whole cache lines
+
+	const CFFTPlan<T> planX; //FFT tables for rows, reused every frame
+	const CFFTPlan<T> planY; //FFT tables for columns
+
+	Ocean(double lx, double ly, int nx, int ny, double wind_speed, double min_wave_size, double A, ThreadPool *shared, int threads);
+
+	ThreadPool *ownPool; //0 if pool is shared
+	ThreadPool &pool; //threads splitting rows and columns of every frame
+
+	complex **phase, //exp(iwt) of every wave in fixed time step mode, 0 until setTimeStep
+			**rotation; //exp(iw dt) of every wave
+	int steps; //steps since setTimeStep
+
+	static const int renormalizeSteps = 64; //steps between bringing length of phases back to 1
+
+	complex **D, //choppy displacement, spectrum and after FFT dx as real and dz as imaginary part, 0 if off
+			**S; //slopes, spectrum and after FFT dh/dx as real and dh/dz as imaginary part, 0 if off
+	double choppy; //scale of displacement
+
+	Timings timings; //of last height calculation
 };
\ No newline at end of file
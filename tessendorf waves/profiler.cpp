@@ -0,0 +1,69 @@
+#include "profiler.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+Profiler::Profiler(const std::vector<std::string> &stages, int frames) :
+	names(stages), samples((frames < 1 ? 1 : frames) * stages.size(), -1.0), frames(frames < 1 ? 1 : frames), current(0), closed(0), sorted(this->frames) {
+}
+
+void Profiler::record(int stage, double seconds) {
+	double &sample = samples[current * names.size() + stage];
+	sample = sample < 0 ? seconds : sample + seconds;
+}
+
+void Profiler::endFrame() {
+	current = (current + 1) % frames;
+	closed = std::min(closed + 1, frames - 1);
+
+	//slot of next frame still has the oldest frame
+	std::fill(samples.begin() + current * names.size(), samples.begin() + (current + 1) * names.size(), -1.0);
+}
+
+const double* Profiler::frame(int age) const {
+	return &samples[((current - 1 - age + 2 * frames) % frames) * names.size()];
+}
+
+Profiler::Stats Profiler::stats(int stage) const {
+
+	//statistics are calculated when asked, recording stays cheap
+
+	size_t n = 0;
+	for (int age = 0; age < closed; age++) {
+		if (frame(age)[stage] >= 0) sorted[n++] = frame(age)[stage];
+	}
+
+	Stats stats = { 0, 0, 0, closed ? frame(0)[stage] : -1, (int)n };
+	if (!n) return stats;
+
+	std::sort(sorted.begin(), sorted.begin() + n);
+	stats.min = sorted[0];
+	for (size_t i = 0; i < n; i++) stats.avg += sorted[i];
+	stats.avg /= n;
+	stats.p99 = sorted[std::min(n - 1, (n * 99 + 99) / 100 - 1)];
+
+	return stats;
+}
+
+bool Profiler::writeCsv(const char *path) const {
+
+	FILE *file = fopen(path, "w");
+	if (!file) return false;
+
+	fprintf(file, "frame");
+	for (size_t s = 0; s < names.size(); s++) fprintf(file, ",%s_ms", names[s].c_str());
+	fprintf(file, "\n");
+
+	//stage not run in frame has empty field
+	for (int age = closed - 1; age >= 0; age--) {
+		fprintf(file, "%d", closed - 1 - age);
+		for (size_t s = 0; s < names.size(); s++) {
+			if (frame(age)[s] >= 0) fprintf(file, ",%.4f", frame(age)[s] * 1000);
+			else fprintf(file, ",");
+		}
+		fprintf(file, "\n");
+	}
+
+	fclose(file);
+	return true;
+}
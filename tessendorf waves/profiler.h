@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+//timings of stages of every frame kept in ring of last frames,
+//stage not run in a frame has no sample and is skipped in statistics
+class Profiler {
+public:
+
+	Profiler(const std::vector<std::string> &stages, int frames = 300); //frames - size of ring
+
+	void record(int stage, double seconds); //add time of stage to current frame, stage can be recorded many times in one frame
+	void endFrame(); //close current frame and start next one, the oldest frame is overwritten when ring is full
+
+	struct Stats {
+		double min, avg, p99, last; //seconds, last is of last closed frame, -1 if stage was not run in it
+		int samples; //closed frames with stage run, 0 if stage has no statistics
+	};
+	Stats stats(int stage) const; //statistics of closed frames in ring
+
+	int stages() const { return (int)names.size(); }
+	const std::string& name(int stage) const { return names[stage]; }
+
+	bool writeCsv(const char *path) const; //closed frames from the oldest, one row per frame, times in milliseconds
+
+	typedef std::chrono::steady_clock Clock;
+
+private:
+
+	const double* frame(int age) const; //closed frame, age 0 is the last one
+
+	std::vector<std::string> names;
+	std::vector<double> samples; //frames x stages ring, -1 for stage not run
+	const int frames;
+	int current; //frame being recorded
+	int closed; //closed frames in ring
+	mutable std::vector<double> sorted; //samples of stage sorted by stats, sized once, so stats allocates nothing
+};
+
+//measures time from its construction to end of scope and records it in profiler,
+//stage is also recorded in trace under its name when tracing is enabled, null profiler turns both off
+class ScopedTimer {
+public:
+
+	ScopedTimer(Profiler *profiler, int stage) : profiler(profiler), stage(stage), start(Profiler::Clock::now()) {}
+	~ScopedTimer() {
+		if (!profiler) return;
+		Profiler::Clock::time_point end = Profiler::Clock::now();
+		profiler->record(stage, std::chrono::duration<double>(end - start).count());
+		if (Trace::enabled()) Trace::record(profiler->name(stage).c_str(), Trace::time(start), Trace::time(end));
+	}
+
+private:
+
+	Profiler *profiler;
+	const int stage;
+	const Profiler::Clock::time_point start;
+};
@@ -0,0 +1,71 @@
+#include "simulation.h"
+
+#include <chrono>
+
+Simulation::Simulation(Cascades *cascades, double t, double dt, int frames) :
+	cascades(cascades), heightStride(cascades->stride()), time(t), dt(dt), target(t),
+	frames(frames < 2 ? 2 : frames, std::vector<float>(cascades->frameSize())), timings(this->frames.size()), times(this->frames.size()),
+	head(0), tail(0), stop(false),
+	worker(&Simulation::run, this) {
+}
+
+void Simulation::run() {
+
+	const unsigned int n = (unsigned int)frames.size();
+	Trace::setThreadName("simulation");
+	cascades->setTimeStep(time, dt);
+
+	while (!stop.load(std::memory_order_relaxed)) {
+		unsigned int pushed = head.load(std::memory_order_relaxed);
+
+		//ring is full, renderer is n frames behind, wait for it without holding a core
+		if (pushed - tail.load(std::memory_order_acquire) == n) {
+			ScopedTrace trace("ring full");
+			std::this_thread::sleep_for(std::chrono::microseconds(500));
+			continue;
+		}
+
+		float *frame = frames[pushed % n].data();
+		Timings &frameTimings = timings[pushed % n];
+
+		//previous frame is not written again until ring goes round, so it can be read even if renderer reads it too
+		const float *previous = pushed > 0 ? frames[(pushed - 1) % n].data() : nullptr;
+
+		ScopedTrace trace("simulation frame");
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		//steps are too slow for real time, renderer would skip frames forever, so steps start again from its time
+		double wanted = target.load(std::memory_order_relaxed);
+		if (wanted - time > maxLag * dt) {
+			cascades->setTimeStep(wanted, dt);
+			time = wanted;
+		}
+
+		cascades->step(frame, previous);
+		time += dt;
+		times[pushed % n] = time;
+
+		frameTimings.ocean = cascades->lastTimings().ocean;
+		frameTimings.slopes = cascades->lastTimings().slopes;
+		frameTimings.total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//release makes frame data and timings visible to renderer before new head
+		head.store(pushed + 1, std::memory_order_release);
+	}
+}
+
+const float* Simulation::front() {
+	unsigned int popped = tail.load(std::memory_order_relaxed);
+
+	if (popped == head.load(std::memory_order_acquire)) return nullptr;
+	return frames[popped % frames.size()].data();
+}
+
+void Simulation::pop() {
+	tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+Simulation::~Simulation() {
+	stop = true;
+	worker.join();
+}
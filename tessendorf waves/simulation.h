@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "cascades.h"
+
+//runs cascades of ocean on its own thread, so next frames are computed while renderer draws current one,
+//finished frames go to renderer through lock-free ring with single producer and single consumer
+class Simulation {
+public:
+
+	//no other thread can use cascades until Simulation is deleted, they start fixed steps dt from time t on simulation thread
+	//frames - size of ring, simulation is at most frames steps ahead of renderer
+	Simulation(Cascades *cascades, double t, double dt, int frames = 3);
+	~Simulation(); //stops simulation thread, frames not taken by renderer are dropped
+
+	int stride() const { return heightStride; } //floats for every texel of height map of one cascade
+	int size() const { return (int)frames[0].size(); } //floats of frame, height maps of all cascades followed by their slope maps
+
+	const float* front(); //oldest finished frame, null if simulation has not finished any frame yet
+	void pop(); //give frame from front back to simulation, pointer from front must not be used after it
+	int ready() const { return (int)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed)); } //finished frames in ring
+	double frontTime() const { return times[tail.load(std::memory_order_relaxed) % frames.size()]; } //ocean time of frame from front
+
+	//ocean time shown by renderer, simulation more than maxLag steps behind it starts its steps again from it
+	void setTarget(double t) { target.store(t, std::memory_order_relaxed); }
+
+	//duration in seconds of stages of frame
+	struct Timings {
+		Ocean<float>::Timings ocean; //stages of stepHeightMap summed over cascades
+		double slopes; //setSlopeMap summed over cascades
+		double total; //whole frame
+	};
+	const Timings& frontTimings() const { return timings[tail.load(std::memory_order_relaxed) % frames.size()]; } //of frame from front
+
+private:
+
+	void run(); //loop of simulation thread
+
+	static const int maxLag = 8;
+
+	Cascades *cascades;
+	const int heightStride;
+	double time; //of last frame pushed, used only by simulation thread
+	const double dt;
+	std::atomic<double> target;
+
+	std::vector<std::vector<float>> frames;
+	std::vector<Timings> timings; //of every frame in ring
+	std::vector<double> times; //ocean time of every frame in ring
+	std::atomic<unsigned int> head; //frames pushed by simulation, written only by simulation thread
+	std::atomic<unsigned int> tail; //frames popped by renderer, written only by renderer thread
+	std::atomic<bool> stop;
+
+	std::thread worker; //started last, after every member is ready
+};
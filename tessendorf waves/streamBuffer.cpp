@@ -0,0 +1,88 @@
+#include "streamBuffer.h"
+
+StreamBuffer::StreamBuffer(GLenum target, int regions) :
+	target(target), persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage),
+	buffer(0), regionSize(0), data(nullptr), region(nullptr), fences(regions < 1 ? 1 : regions, (GLsync)0), current(0) {
+}
+
+void StreamBuffer::allocate(GLsizeiptr size) {
+
+	release();
+
+	regionSize = (size + alignment - 1) / alignment * alignment;
+	GLsizeiptr total = regionSize * fences.size();
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+
+	//coherent mapping makes writes visible to GPU without flushing
+	if (persistent) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(target, total, NULL, flags);
+		data = (char*)glMapBufferRange(target, 0, total, flags);
+	}
+	else {
+		glBufferData(target, total, NULL, GL_STREAM_DRAW);
+	}
+
+	glBindBuffer(target, 0);
+	current = 0;
+}
+
+void StreamBuffer::release() {
+
+	//GL deletes buffer only after commands which use it are finished, so fences are not waited
+
+	for (size_t i = 0; i < fences.size(); i++) {
+		if (fences[i]) glDeleteSync(fences[i]);
+		fences[i] = 0;
+	}
+
+	if (buffer) {
+		glDeleteBuffers(1, &buffer);
+		buffer = 0;
+		data = nullptr;
+	}
+}
+
+void* StreamBuffer::begin(GLsizeiptr size) {
+
+	if (size > regionSize) allocate(size);
+
+	//usually region was used 2 frames ago and its fence is already signaled
+	GLsync &sync = fences[current];
+	if (sync) {
+		while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+		glDeleteSync(sync);
+		sync = 0;
+	}
+
+	if (persistent) {
+		region = data + current*regionSize;
+	}
+	else {
+		//fence already protects region, so driver does not need to synchronize it again
+		glBindBuffer(target, buffer);
+		region = (char*)glMapBufferRange(target, current*regionSize, regionSize, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+		glBindBuffer(target, 0);
+	}
+
+	return region;
+}
+
+GLintptr StreamBuffer::end() {
+
+	glBindBuffer(target, buffer);
+	if (!persistent) glUnmapBuffer(target);
+
+	return current*regionSize;
+}
+
+void StreamBuffer::fence() {
+	fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	current = (current + 1) % fences.size();
+}
+
+StreamBuffer::~StreamBuffer() {
+	release();
+}
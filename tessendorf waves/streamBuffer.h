@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "GL/glew.h"
+
+//buffer for data sent to GPU every frame, split into ring of regions,
+//CPU writes next region while GPU still reads previous ones and fences tell when region is free again
+//with ARB_buffer_storage whole buffer is mapped persistently, so data is written straight to GPU visible memory,
+//without it every region is mapped unsynchronized for writing
+class StreamBuffer {
+public:
+
+	StreamBuffer(GLenum target, int regions = 3); //target - binding of buffer e.g. GL_PIXEL_UNPACK_BUFFER, needs current GL context
+	~StreamBuffer();
+
+	void* begin(GLsizeiptr size); //wait until next region is free and return it for writing size bytes, buffer grows if size is larger than region
+	GLintptr end(); //finish writing region, binds buffer and returns offset of region to use in draw or upload commands
+	void fence(); //mark region as used by commands issued after end, it is not written again until they finish
+
+	GLuint id() const { return buffer; }
+
+private:
+
+	void allocate(GLsizeiptr size); //create buffer with regions of at least size bytes
+	void release(); //delete buffer and fences
+
+	static const GLsizeiptr alignment = 256; //start of every region, enough for any texel or vertex type
+
+	const GLenum target;
+	const bool persistent; //buffer storage is available and buffer stays mapped
+
+	GLuint buffer;
+	GLsizeiptr regionSize;
+	char *data; //persistently mapped buffer, null without ARB_buffer_storage
+	char *region; //region currently written
+
+	std::vector<GLsync> fences; //fence of every region, 0 if region is not used by GPU
+	int current; //region currently written
+};
@@ -0,0 +1,81 @@
+#include "threadPool.h"
+#include "trace.h"
+
+ThreadPool::ThreadPool(int threads) :
+	threads(threads < 1 ? 1 : threads), call(nullptr), task(nullptr), n(0), generation(0), pending(0), stop(false) {
+
+	//calling thread does part 0, workers do the rest
+	for (int i = 1; i < this->threads; i++) {
+		workers.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+void ThreadPool::run(int n, Invoke call, const void *task) {
+
+	if (threads == 1) {
+		ScopedTrace trace("parallelFor part");
+		call(task, 0, 0, n);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->call = call;
+		this->task = task;
+		this->n = n;
+		pending = threads - 1;
+		generation++;
+	}
+	started.notify_all();
+
+	{
+		ScopedTrace trace("parallelFor part");
+		call(task, 0, 0, n / threads);
+	}
+
+	//waiting for slowest worker is visible in trace as gap after part of calling thread
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return pending == 0; });
+}
+
+void ThreadPool::work(int part) {
+
+	unsigned int seen = 0;
+	Trace::setThreadName("ocean pool worker");
+
+	for (;;) {
+		Invoke current;
+		const void *currentTask;
+		int count;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			started.wait(lock, [this, seen] { return stop || generation != seen; });
+			if (stop) return;
+			seen = generation;
+			current = call;
+			currentTask = task;
+			count = n;
+		}
+
+		//parts are as equal as possible, 64 bit product avoids overflow for large ranges
+		{
+			ScopedTrace trace("parallelFor part");
+			current(currentTask, part, int((long long)count * part / threads), int((long long)count * (part + 1) / threads));
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--pending == 0) finished.notify_one();
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	started.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+}
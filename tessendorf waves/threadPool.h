@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class ThreadPool {
+public:
+
+	ThreadPool(int threads); //threads - number of threads working on every task, calling thread included
+	~ThreadPool();
+
+	int size() const { return threads; }
+
+	//split range [0, n) into size() parts and call task(part, begin, end) for every part in parallel,
+	//returns when all parts are done so it works as a barrier between tasks,
+	//task is passed by pointer, so nothing is allocated on heap for it
+	template <typename F>
+	void parallelFor(int n, const F &task) { run(n, &invoke<F>, &task); }
+
+private:
+
+	typedef void (*Invoke)(const void *task, int part, int begin, int end);
+
+	template <typename F>
+	static void invoke(const void *task, int part, int begin, int end) { (*static_cast<const F*>(task))(part, begin, end); }
+
+	void run(int n, Invoke call, const void *task); //parallelFor of task called with call
+
+	void work(int part); //loop of worker thread, part - index of range handled by this worker
+
+	const int threads;
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable started; //new task or stop request
+	std::condition_variable finished; //all workers finished current task
+
+	Invoke call; //current task and function calling it
+	const void *task;
+	int n; //range of current task
+	unsigned int generation; //incremented for every task, workers compare it with last seen value
+	int pending; //workers which have not finished current task
+	bool stop;
+};
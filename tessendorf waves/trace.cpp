@@ -0,0 +1,171 @@
+#include "trace.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::isEnabled(false);
+
+namespace {
+
+	//fields are relaxed atomics, so writer can overwrite event while it is read,
+	//reader finds such events with counter of written events and drops them
+	struct Event {
+		std::atomic<const char*> name;
+		std::atomic<long long> start, end;
+	};
+
+	const unsigned long long capacity = 1 << 16; //events in ring of every thread
+	const size_t maxBuffers = 32; //above it events of the oldest finished thread are dropped for new thread
+
+	struct Buffer {
+		std::unique_ptr<Event[]> events;
+		std::atomic<unsigned long long> written; //events written since buffer was taken by thread
+		unsigned long long saved; //written at last Trace::write, changed only with registry mutex
+		const char *name;
+		int tid;
+		bool used; //taken by living thread, changed only with registry mutex
+
+		Buffer() : events(new Event[capacity]), written(0), saved(0), name(nullptr), tid(0), used(false) {}
+	};
+
+	//buffers of finished threads are kept until their events are written and then reused by new threads,
+	//so threads of recreated pools do not take new memory and trace still has events of threads they replaced
+	std::mutex registry;
+	std::vector<std::unique_ptr<Buffer>> buffers;
+	int threads = 0;
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	//releases buffer when its thread finishes, buffer is taken by the first event, so threads which never record take no memory
+	struct Owner {
+		Buffer *buffer = nullptr;
+		const char *name = nullptr; //from setThreadName, given to buffer when it is taken
+
+		~Owner() {
+			if (!buffer) return;
+			std::lock_guard<std::mutex> lock(registry);
+			buffer->used = false;
+		}
+	};
+
+	thread_local Owner owner;
+
+	Buffer* threadBuffer() {
+		if (owner.buffer) return owner.buffer;
+
+		//only the first event of thread takes lock
+		std::lock_guard<std::mutex> lock(registry);
+
+		Buffer *buffer = nullptr, *oldest = nullptr;
+		for (size_t i = 0; i < buffers.size() && !buffer; i++) {
+			Buffer *finished = buffers[i].get();
+			if (finished->used) continue;
+
+			if (finished->saved == finished->written.load(std::memory_order_relaxed)) buffer = finished;
+			else if (!oldest || finished->tid < oldest->tid) oldest = finished;
+		}
+		if (!buffer && buffers.size() >= maxBuffers) buffer = oldest;
+		if (!buffer) {
+			buffers.emplace_back(new Buffer());
+			buffer = buffers.back().get();
+		}
+
+		buffer->used = true;
+		buffer->written.store(0, std::memory_order_relaxed);
+		buffer->saved = 0;
+		buffer->name = owner.name;
+		buffer->tid = ++threads;
+
+		owner.buffer = buffer;
+		return buffer;
+	}
+}
+
+void Trace::enable(bool enable) {
+	isEnabled.store(enable, std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const char *name) {
+	owner.name = name;
+	if (!owner.buffer) return;
+
+	std::lock_guard<std::mutex> lock(registry);
+	owner.buffer->name = name;
+}
+
+long long Trace::time(std::chrono::steady_clock::time_point point) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(point - epoch).count();
+}
+
+void Trace::record(const char *name, long long start, long long end) {
+	Buffer *buffer = threadBuffer();
+
+	unsigned long long i = buffer->written.load(std::memory_order_relaxed);
+	Event &event = buffer->events[i % capacity];
+
+	//fence pairs with acquire fence of reader, which sees counter of this event when it sees any of its fields,
+	//so event overwritten while it is copied is always dropped
+	std::atomic_thread_fence(std::memory_order_release);
+	event.name.store(name, std::memory_order_relaxed);
+	event.start.store(start, std::memory_order_relaxed);
+	event.end.store(end, std::memory_order_relaxed);
+
+	//release makes event visible to reader which sees new counter
+	buffer->written.store(i + 1, std::memory_order_release);
+}
+
+bool Trace::write(const char *path) {
+
+	FILE *file = fopen(path, "w");
+	if (!file) return false;
+
+	//lock keeps buffers from being reused while they are read, threads still record to them
+	std::lock_guard<std::mutex> lock(registry);
+
+	fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	bool first = true;
+
+	for (size_t b = 0; b < buffers.size(); b++) {
+		Buffer &buffer = *buffers[b];
+
+		if (buffer.name) {
+			fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+				first ? "" : ",\n", buffer.tid, buffer.name);
+			first = false;
+		}
+
+		unsigned long long written = buffer.written.load(std::memory_order_acquire);
+		unsigned long long begin = written > capacity ? written - capacity : 0;
+
+		std::vector<Event> events(written - begin);
+		for (unsigned long long i = begin; i < written; i++) {
+			const Event &event = buffer.events[i % capacity];
+			events[i - begin].name.store(event.name.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			events[i - begin].start.store(event.start.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			events[i - begin].end.store(event.end.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+		//events overwritten while they were copied, including the one being written now, are dropped
+		std::atomic_thread_fence(std::memory_order_acquire);
+		unsigned long long overwritten = buffer.written.load(std::memory_order_relaxed);
+		unsigned long long valid = overwritten >= capacity ? overwritten - capacity + 1 : 0;
+
+		buffer.saved = written;
+
+		for (unsigned long long i = begin > valid ? begin : valid; i < written; i++) {
+			const Event &event = events[i - begin];
+			long long start = event.start.load(std::memory_order_relaxed), end = event.end.load(std::memory_order_relaxed);
+
+			fprintf(file, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+				first ? "" : ",\n", event.name.load(std::memory_order_relaxed), buffer.tid, start / 1000.0, (end - start) / 1000.0);
+			first = false;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+//recorder of timeline events of every thread in Chrome trace event format, opened by chrome://tracing or ui.perfetto.dev
+//every thread records to its own ring of events without locks, when ring is full the oldest events are overwritten,
+//so tracing can stay enabled all the time, disabled tracing costs one relaxed load for every scope
+//names of events and threads are kept as pointers, they must live until trace is written, string literals are expected
+class Trace {
+public:
+
+	static void enable(bool enable);
+	static bool enabled() { return isEnabled.load(std::memory_order_relaxed); }
+
+	static void setThreadName(const char *name); //name of calling thread shown in trace, takes no memory until thread records
+	static long long now() { return time(std::chrono::steady_clock::now()); } //nanoseconds since start of program
+	static long long time(std::chrono::steady_clock::time_point point); //time of point in nanoseconds since start of program, for stages timed anyway
+	static void record(const char *name, long long start, long long end); //event of calling thread between times from now
+
+	static bool write(const char *path); //write events of all threads to JSON file, threads can record at the same time
+
+private:
+
+	static std::atomic<bool> isEnabled;
+};
+
+//records event from its construction to end of scope if tracing is enabled at construction
+class ScopedTrace {
+public:
+
+	ScopedTrace(const char *name) : name(Trace::enabled() ? name : nullptr), start(this->name ? Trace::now() : 0) {}
+	~ScopedTrace() {
+		if (name) Trace::record(name, start, Trace::now());
+	}
+
+private:
+
+	const char *name;
+	const long long start;
+};
@@ -1,18 +1,42 @@
 #version 330 core
 
-in vec3 pos;
-in vec3 normal;
+in vec2 grid; //x, z of vertex in cells from center of clipmap level
 
 out vec3 o_pos;
-out vec3 o_normal;
+out vec2 o_grid; //x, z of surface before displacement, where fragment shader samples slopes
 
 uniform mat4 P;
 uniform mat4 V;
 uniform mat4 M;
 
+uniform sampler2DArray heightMap; //height, x and z displacement of choppy waves, without choppy waves only height, layer for every cascade
+uniform vec2 tileSize[3]; //real ocean width and length covered by one repeat of textures of every cascade
+uniform int cascades; //layers of textures
+
+uniform vec2 origin; //x, z of center of level, multiple of two cells, so every second vertex is vertex of next level
+uniform float cellSize; //distance between vertices of level
+uniform vec2 morphRange; //distance from center in cells where morph to next level starts and width of morph
+
 void main()
 {	
-	o_normal = normal;
+	//near outer edge odd vertices move onto even ones, at edge level has only vertices of next level
+	float morph = clamp((max(abs(grid.x), abs(grid.y)) - morphRange.x)/morphRange.y, 0, 1);
+	vec2 xz = origin + (grid - fract(grid*0.5)*2*morph)*cellSize;
+
+	//heights and displacement of all cascades are summed
+	vec2 texels = vec2(textureSize(heightMap, 0).xy);
+	vec3 field = vec3(0);
+	for (int c = 0; c < cascades; c++) {
+		//mip level has one texel for every cell, so far levels and small cascades do not alias, at edge it is mip level of next level
+		float lod = max(0, log2(cellSize*texels.x/tileSize[c].x) + morph);
+
+		//texel i is sampled exactly at vertex i of full density grid, between texels for any other density
+		vec2 uv = xz/tileSize[c] + 0.5/texels;
+		field += textureLod(heightMap, vec3(uv, c), lod).rgb;
+	}
+
+	o_grid = xz;
+	vec3 pos = vec3(xz.x + field.g, field.r, xz.y + field.b);
 	vec4 position =  M*vec4(pos,1);
 	o_pos = position.xyz;
 